@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    bench_at_framer.cpp
+  * @brief   Host microbenchmark of the framer of the AT answers against the
+  *          former search of the whole buffer with strstr, over recorded
+  *          answers received in one part or in chunks.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "at_framer.h"
+
+#define AT_OK_STRING     "\r\nOK\r\n> "
+#define AT_ERROR_STRING  "\r\nERROR"
+#define ROUNDS           20000
+
+typedef struct {
+  const char *name;
+  char data[1600];
+  size_t len;
+} Answer_t;
+
+static Answer_t answers[3];
+
+static void record(Answer_t *answer, const char *name, const char *head, char fill,
+                   size_t fillLen, const char *tail)
+{
+  answer->name = name;
+  answer->len = strlen(head);
+  memcpy(answer->data, head, answer->len);
+  memset(answer->data + answer->len, fill, fillLen);
+  answer->len += fillLen;
+  memcpy(answer->data + answer->len, tail, strlen(tail));
+  answer->len += strlen(tail);
+}
+
+/* Answers of R0 with a full payload, F0 with 10 APs and C? */
+static void recordAnswers(void)
+{
+  static char scan[1200];
+  size_t len = 0;
+
+  record(&answers[0], "R0 1200 bytes", "\r\n", 'x', 1200, AT_OK_STRING);
+  for (int i = 0; i < 10; i++) {
+    len += sprintf(scan + len, "#%03d,\"Network-%02d\",00:11:22:33:44:%02X,-%02d,3,11,0,0,0\r\n",
+                   i + 1, i, i, 40 + i);
+  }
+  record(&answers[1], "F0 10 APs", "\r\n", ' ', 0, scan);
+  memcpy(answers[1].data + answers[1].len, AT_OK_STRING, strlen(AT_OK_STRING));
+  answers[1].len += strlen(AT_OK_STRING);
+  record(&answers[2], "C? settings", "\r\nMyNetwork,password,3,1,0,192.168.1.10,255.255.255.0,"
+         "192.168.1.1,192.168.1.1,0.0.0.0,0,0,0", ' ', 0, AT_OK_STRING);
+}
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Former way: the buffer is terminated and searched after each part */
+static int strstrStatus(const Answer_t *answer, size_t chunk)
+{
+  static char buffer[1600 + 1];
+  int status = 0;
+
+  for (size_t pos = 0; (pos < answer->len) && (status == 0); pos += chunk) {
+    size_t len = (answer->len - pos < chunk) ? (answer->len - pos) : chunk;
+
+    memcpy(buffer + pos, answer->data + pos, len);
+    buffer[pos + len] = '\0';
+    if (strstr(buffer, AT_OK_STRING)) {
+      status = 1;
+    } else if (strstr(buffer, AT_ERROR_STRING)) {
+      status = 2;
+    }
+  }
+  return status;
+}
+
+static int framerStatus(AtFramerClass &framer, const Answer_t *answer, size_t chunk)
+{
+  AT_FrameStatus_t status = AT_FRAME_PENDING;
+
+  framer.Reset();
+  for (size_t pos = 0; (pos < answer->len) && (status == AT_FRAME_PENDING); pos += chunk) {
+    size_t len = (answer->len - pos < chunk) ? (answer->len - pos) : chunk;
+
+    status = framer.Feed((const uint8_t *)answer->data + pos, len);
+  }
+  return (int)status;
+}
+
+int main(void)
+{
+  static const size_t chunks[] = { 1600, 64 };
+  AtFramerClass framer;
+  volatile int sink = 0;
+
+  recordAnswers();
+  printf("%-14s %6s %12s %12s\n", "answer", "chunk", "strstr ns", "framer ns");
+  for (size_t a = 0; a < sizeof(answers) / sizeof(answers[0]); a++) {
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+      double start = now();
+      double strstrTime, framerTime;
+
+      for (int i = 0; i < ROUNDS; i++) {
+        sink += strstrStatus(&answers[a], chunks[c]);
+      }
+      strstrTime = now() - start;
+      start = now();
+      for (int i = 0; i < ROUNDS; i++) {
+        sink += framerStatus(framer, &answers[a], chunks[c]);
+      }
+      framerTime = now() - start;
+      printf("%-14s %6u %12.0f %12.0f\n", answers[a].name, (unsigned)chunks[c],
+             strstrTime * 1e9 / ROUNDS, framerTime * 1e9 / ROUNDS);
+    }
+  }
+  return (sink == 0) ? 1 : 0;
+}
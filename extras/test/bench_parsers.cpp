@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    bench_parsers.cpp
+  * @brief   Host microbenchmark of the table-driven decoders of the driver
+  *          against the former ones, one character at a time.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <time.h>
+/* The decoders are private members of the driver */
+#define private public
+#include "ISM43362_M3G_L44_driver.h"
+#undef private
+#include "ref_parsers.h"
+
+#define ROUNDS  2000000
+
+static SPIClass spi;
+static volatile uint32_t sink;
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+  static IsmDrvClass drv(&spi, 3, 2, 4, 5);
+  char mac[] = "00:1A:2B:3C:4D:5E,";
+  char ip[] = "192.168.100.200,";
+  char hex[] = "1A2B3C4D,";
+  char num[] = "-1234567,";
+  uint8_t out[6];
+  uint8_t cnt;
+  double start, former, table;
+
+  printf("%-8s %12s %12s\n", "field", "former ns", "table ns");
+
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    RefParseMAC(mac, out);
+    sink += out[5];
+  }
+  former = now() - start;
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    drv.ParseMAC(mac, out);
+    sink += out[5];
+  }
+  table = now() - start;
+  printf("%-8s %12.1f %12.1f\n", "MAC", former * 1e9 / ROUNDS, table * 1e9 / ROUNDS);
+
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    RefParseIP(ip, out);
+    sink += out[3];
+  }
+  former = now() - start;
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    drv.ParseIP(ip, out);
+    sink += out[3];
+  }
+  table = now() - start;
+  printf("%-8s %12.1f %12.1f\n", "IP", former * 1e9 / ROUNDS, table * 1e9 / ROUNDS);
+
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    sink += RefParseHexNumber(hex, &cnt);
+  }
+  former = now() - start;
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    sink += drv.ParseHexNumber(hex, &cnt);
+  }
+  table = now() - start;
+  printf("%-8s %12.1f %12.1f\n", "hex", former * 1e9 / ROUNDS, table * 1e9 / ROUNDS);
+
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    sink += RefParseNumber(num, &cnt);
+  }
+  former = now() - start;
+  start = now();
+  for (int i = 0; i < ROUNDS; i++) {
+    sink += drv.ParseNumber(num, &cnt);
+  }
+  table = now() - start;
+  printf("%-8s %12.1f %12.1f\n", "decimal", former * 1e9 / ROUNDS, table * 1e9 / ROUNDS);
+  return 0;
+}
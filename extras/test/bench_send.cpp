@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file    bench_send.cpp
+  * @brief   Host benchmark of the exchanges needed to send small messages to
+  *          a socket: S3 with the length, against S1 then S0 on the firmware
+  *          without S3. The simulated module takes 1 ms per command.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include "ISM43362_M3G_L44_driver.h"
+#include "sim_spi_module.h"
+#include "sim_module_answers.h"
+
+#define MESSAGES  100
+
+static SPIClass spi;
+static uint8_t data[ES_WIFI_PAYLOAD_SIZE];
+
+static int run(const char *firmware, bool sameSize)
+{
+  IsmDrvClass drv(&spi, SIM_PIN_CS, SIM_PIN_DATA_READY, SIM_PIN_RESET, SIM_PIN_WAKEUP);
+  uint32_t start;
+  size_t sent;
+
+  simFirmware = firmware;
+  simModule.latency = 0;
+  if (drv.ES_WIFI_Init() != ES_WIFI_STATUS_OK) {
+    printf("bench_send: init failed\n");
+    return -1;
+  }
+  /* Socket selected and timeout set once */
+  drv.ES_WIFI_SendResp(0, data, 1, &sent, 1000);
+
+  simModule.latency = 1;
+  simModule.ResetCounters();
+  start = micros();
+  for (int i = 0; i < MESSAGES; i++) {
+    drv.ES_WIFI_SendResp(0, data, sameSize ? 32 : 16 + (i % 32), &sent, 1000);
+  }
+  printf("%-14s %-9s %10.2f %10.2f\n", firmware, sameSize ? "same" : "varying",
+         (double)simModule.commands / MESSAGES, (micros() - start) / 1000.0 / MESSAGES);
+  return 0;
+}
+
+int main(void)
+{
+  simPins = &simModule;
+  simModule.respond = simAnswer;
+  memset(data, 'x', sizeof(data));
+
+  printf("%-14s %-9s %10s %10s\n", "firmware", "sizes", "commands", "ms");
+  if ((run("C3.5.2.3.STM", true) != 0) || (run("C3.5.2.3.STM", false) != 0) ||
+      (run("C3.5.2.5.STM", true) != 0) || (run("C3.5.2.5.STM", false) != 0)) {
+    return 1;
+  }
+  return 0;
+}
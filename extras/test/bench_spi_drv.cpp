@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    bench_spi_drv.cpp
+  * @brief   Host benchmark of the SPI driver: calls to the SPI library and
+  *          reads of the data ready pin per kilobyte, against the former
+  *          transfer of one 16-bit word at a time.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string>
+#include "spi_drv.h"
+#include "sim_spi_module.h"
+
+#define PAYLOAD  1024
+
+static SPIClass spi;
+static uint8_t buffer[PAYLOAD + 64];
+
+/* Former IO_Send: one word per call */
+static void perWordSend(const uint8_t *data, uint16_t len)
+{
+  digitalWrite(SIM_PIN_CS, LOW);
+  for (uint16_t i = 0; i < len; i += 2) {
+    spi.transfer16(data[i] | ((i + 1 < len) ? data[i + 1] : '\n') << 8);
+  }
+}
+
+/* Former IO_Receive: one word per call, the pin read twice per word */
+static uint16_t perWordReceive(uint8_t *data)
+{
+  uint16_t len = 0;
+  uint16_t word;
+
+  digitalWrite(SIM_PIN_CS, HIGH);
+  while (!digitalRead(SIM_PIN_DATA_READY)) {
+  }
+  digitalWrite(SIM_PIN_CS, LOW);
+  while (digitalRead(SIM_PIN_DATA_READY)) {
+    word = spi.transfer16(0x0A0A);
+    if (!digitalRead(SIM_PIN_DATA_READY) && ((word >> 8) == 0x15)) {
+      if ((word & 0xFF) != 0x15) {
+        data[len++] = word & 0xFF;
+      }
+      break;
+    }
+    data[len++] = word & 0xFF;
+    data[len++] = word >> 8;
+  }
+  digitalWrite(SIM_PIN_CS, HIGH);
+  return len;
+}
+
+static void report(const char *name, uint32_t bytes)
+{
+  printf("%-24s %8lu %8lu %10lu\n", name,
+         (unsigned long)simModule.blockTransfers * 1024 / bytes,
+         (unsigned long)simModule.wordTransfers * 1024 / bytes,
+         (unsigned long)simModule.readyReads * 1024 / bytes);
+}
+
+int main(void)
+{
+  SpiDrvClass drv(&spi, SIM_PIN_CS, SIM_PIN_DATA_READY, SIM_PIN_RESET, SIM_PIN_WAKEUP);
+  std::string payload(PAYLOAD, 'x');
+  std::string answer = "\r\n" + payload + "\r\nOK\r\n> ";
+
+  simPins = &simModule;
+  if (drv.IO_Init(IO_INIT_COLD) != 0) {
+    printf("bench_spi_drv: init failed\n");
+    return 1;
+  }
+  simModule.answer = answer;
+  printf("%-24s %8s %8s %10s\n", "per KB", "blocks", "words", "pin reads");
+
+  simModule.ResetCounters();
+  perWordSend((const uint8_t *)payload.data(), PAYLOAD);
+  report("send, word at a time", PAYLOAD);
+  simModule.ResetCounters();
+  perWordReceive(buffer);
+  report("receive, word at a time", answer.size());
+
+  simModule.ResetCounters();
+  drv.IO_Send((uint8_t *)&payload[0], PAYLOAD, 100);
+  report("send, IO_Send", PAYLOAD);
+  simModule.ResetCounters();
+  if (drv.IO_Receive(buffer, sizeof(buffer), 100) != (int16_t)answer.size()) {
+    printf("bench_spi_drv: receive failed\n");
+    return 1;
+  }
+  report("receive, IO_Receive", answer.size());
+  return 0;
+}
@@ -0,0 +1,90 @@
+/* Former decoders of the driver, one character at a time, as the reference
+   of the table-driven ones                                                 */
+#ifndef REF_PARSERS_H
+#define REF_PARSERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define REF_CHARISHEXNUM(x)  (((x) >= '0' && (x) <= '9') || \
+                              ((x) >= 'a' && (x) <= 'f') || \
+                              ((x) >= 'A' && (x) <= 'F'))
+#define REF_CHARISNUM(x)     ((x) >= '0' && (x) <= '9')
+
+static inline uint8_t RefHex2Num(char a)
+{
+  if (a >= '0' && a <= '9') {
+    return a - '0';
+  } else if (a >= 'a' && a <= 'f') {
+    return (a - 'a') + 10;
+  } else if (a >= 'A' && a <= 'F') {
+    return (a - 'A') + 10;
+  }
+  return 0;
+}
+
+static inline uint32_t RefParseHexNumber(const char *ptr, uint8_t *cnt)
+{
+  uint32_t sum = 0;
+  uint8_t i = 0;
+
+  while (REF_CHARISHEXNUM(*ptr)) {
+    sum <<= 4;
+    sum += RefHex2Num(*ptr);
+    ptr++;
+    i++;
+  }
+  if (cnt != NULL) {
+    *cnt = i;
+  }
+  return sum;
+}
+
+static inline int32_t RefParseNumber(const char *ptr, uint8_t *cnt)
+{
+  uint8_t minus = 0, i = 0;
+  uint32_t sum = 0;
+
+  if (*ptr == '-') {
+    minus = 1;
+    ptr++;
+    i++;
+  }
+  while (REF_CHARISNUM(*ptr)) {
+    sum = 10 * sum + (*ptr - '0');
+    ptr++;
+    i++;
+  }
+  if (cnt != NULL) {
+    *cnt = i;
+  }
+  return minus ? (int32_t)(0 - sum) : (int32_t)sum;
+}
+
+static inline void RefParseMAC(const char *ptr, uint8_t *arr)
+{
+  uint8_t hexnum = 0, hexcnt;
+
+  while ((hexnum < 6) && (REF_CHARISHEXNUM(*ptr) || (*ptr == ':'))) {
+    hexcnt = 1;
+    if (*ptr != ':') {
+      arr[hexnum++] = RefParseHexNumber(ptr, &hexcnt);
+    }
+    ptr = ptr + hexcnt;
+  }
+}
+
+static inline void RefParseIP(const char *ptr, uint8_t *arr)
+{
+  uint8_t hexnum = 0, hexcnt;
+
+  while ((hexnum < 4) && (REF_CHARISNUM(*ptr) || (*ptr == '.') || (*ptr == '-'))) {
+    hexcnt = 1;
+    if (REF_CHARISNUM(*ptr)) {
+      arr[hexnum++] = RefParseNumber(ptr, &hexcnt);
+    }
+    ptr = ptr + hexcnt;
+  }
+}
+
+#endif
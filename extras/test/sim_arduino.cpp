@@ -0,0 +1,125 @@
+/* Host stand-in of the Arduino core */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "sim_arduino.h"
+
+SimPins *simPins = NULL;
+
+static uint64_t nowUs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void pinMode(uint32_t pin, uint32_t mode)
+{
+  UNUSED(pin);
+  UNUSED(mode);
+}
+
+void digitalWrite(uint32_t pin, uint32_t value)
+{
+  if (simPins != NULL) {
+    simPins->Write(pin, value);
+  }
+}
+
+int digitalRead(uint32_t pin)
+{
+  return (simPins != NULL) ? simPins->Read(pin) : LOW;
+}
+
+void attachInterrupt(uint32_t irq, void (*handler)(void), uint32_t mode)
+{
+  UNUSED(irq);
+  UNUSED(handler);
+  UNUSED(mode);
+}
+
+void detachInterrupt(uint32_t irq)
+{
+  UNUSED(irq);
+}
+
+uint32_t millis(void)
+{
+  return (uint32_t)(nowUs() / 1000);
+}
+
+uint32_t micros(void)
+{
+  return (uint32_t)nowUs();
+}
+
+void delay(uint32_t ms)
+{
+  usleep(ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  UNUSED(us);
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+  UNUSED(baud);
+  if (fd >= 0) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+}
+
+void HardwareSerial::end(void)
+{
+}
+
+int HardwareSerial::available(void)
+{
+  int count = 0;
+
+  if ((fd < 0) || (ioctl(fd, FIONREAD, &count) != 0)) {
+    return 0;
+  }
+  return count;
+}
+
+int HardwareSerial::read(void)
+{
+  uint8_t c;
+
+  if ((fd < 0) || (::read(fd, &c, 1) != 1)) {
+    return -1;
+  }
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  ssize_t len;
+
+  if (fd < 0) {
+    return 0;
+  }
+  len = ::write(fd, buffer, size);
+  return (len > 0) ? (size_t)len : 0;
+}
+
+void HardwareSerial::flush(void)
+{
+  if (fd >= 0) {
+    tcdrain(fd);
+  }
+}
@@ -0,0 +1,18 @@
+/* Pins of the host stand-in of the Arduino core: the simulated device
+   drives them.                                                             */
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+
+class SimPins {
+  public:
+    virtual ~SimPins() {}
+    virtual int Read(uint32_t pin) = 0;
+    virtual void Write(uint32_t pin, uint32_t value) = 0;
+};
+
+/* Device wired to the pins, none when NULL: the pins read LOW */
+extern SimPins *simPins;
+
+#endif
@@ -0,0 +1,19 @@
+/* Answers of the simulated module to the AT commands */
+
+#include "sim_module_answers.h"
+
+std::string simFirmware = "C3.5.2.5.STM";
+
+std::string simAnswer(const std::string &command)
+{
+  std::string answer = "\r\n";
+
+  if (command.compare(0, 2, "I?") == 0) {
+    answer += "ISM43362-M3G-L44-SPI," + simFirmware +
+              ",v3.5.2,v1.4.0.rc1,v8.2.1,120000000,Inventek eS-WiFi";
+  } else if ((command.compare(0, 2, "S0") == 0) || (command.compare(0, 2, "S3") == 0)) {
+    /* Number of bytes sent */
+    answer += "0";
+  }
+  return answer + "\r\nOK\r\n> ";
+}
@@ -0,0 +1,12 @@
+/* Answers of the simulated module to the AT commands */
+#ifndef SIM_MODULE_ANSWERS_H
+#define SIM_MODULE_ANSWERS_H
+
+#include <string>
+
+/* Firmware revision returned by I? */
+extern std::string simFirmware;
+
+std::string simAnswer(const std::string &command);
+
+#endif
@@ -0,0 +1,129 @@
+/* Module simulated behind the SPI bus */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "sim_spi_module.h"
+
+SimSpiModule simModule;
+
+SimSpiModule::SimSpiModule()
+{
+  state = SIM_IDLE;
+  selected = false;
+  latency = 0;
+  respond = NULL;
+  pos = 0;
+  readyAt = 0;
+  ResetCounters();
+}
+
+void SimSpiModule::ResetCounters(void)
+{
+  commands = 0;
+  blockTransfers = 0;
+  wordTransfers = 0;
+  readyReads = 0;
+}
+
+void SimSpiModule::StartAnswer(const std::string &data)
+{
+  sending = data;
+  if (sending.size() & 1) {
+    sending += '\x15';
+  }
+  pos = 0;
+  state = sending.empty() ? SIM_DONE : SIM_ANSWER;
+}
+
+int SimSpiModule::Read(uint32_t pin)
+{
+  if (pin != SIM_PIN_DATA_READY) {
+    return LOW;
+  }
+  readyReads++;
+  switch (state) {
+    case SIM_IDLE:
+    case SIM_COMMAND:
+      return HIGH;
+    case SIM_BUSY:
+      if ((int32_t)(micros() - readyAt) < 0) {
+        return LOW;
+      }
+      StartAnswer(answer);
+      return HIGH;
+    case SIM_ANSWER:
+      return HIGH;
+    default:
+      return LOW;
+  }
+}
+
+void SimSpiModule::Write(uint32_t pin, uint32_t value)
+{
+  if (pin == SIM_PIN_RESET) {
+    if (value == LOW) {
+      state = SIM_RESET;
+    } else if (state == SIM_RESET) {
+      /* Prompt sent once booted */
+      StartAnswer(std::string("\x15\x15\r\n> "));
+    }
+  } else if (pin == SIM_PIN_CS) {
+    selected = (value == LOW);
+    if (selected && (state == SIM_IDLE)) {
+      command.clear();
+      state = SIM_COMMAND;
+    } else if (!selected && (state == SIM_COMMAND) && !command.empty()) {
+      commands++;
+      if (respond != NULL) {
+        answer = respond(command);
+      }
+      readyAt = micros() + latency * 1000;
+      state = SIM_BUSY;
+    } else if (!selected && ((state == SIM_DONE) || (state == SIM_COMMAND))) {
+      state = SIM_IDLE;
+    }
+  }
+}
+
+void SimSpiModule::Transfer(uint8_t *bus, size_t count)
+{
+  uint8_t c;
+
+  for (size_t i = 0; i + 1 < count; i += 2) {
+    if (!selected) {
+      continue;
+    }
+    if (state == SIM_COMMAND) {
+      command += (char)bus[i + 1];
+      command += (char)bus[i];
+    } else if (state == SIM_ANSWER) {
+      /* Once the answer is sent the words are padded with 0x15 */
+      c = (pos < sending.size()) ? sending[pos] : 0x15;
+      bus[i + 1] = c;
+      c = (pos + 1 < sending.size()) ? sending[pos + 1] : 0x15;
+      bus[i] = c;
+      pos += 2;
+      if (pos >= sending.size()) {
+        state = SIM_DONE;
+      }
+    } else {
+      bus[i] = 0x15;
+      bus[i + 1] = 0x15;
+    }
+  }
+}
+
+uint16_t SPIClass::transfer16(uint16_t data)
+{
+  uint8_t bus[2] = { (uint8_t)(data >> 8), (uint8_t)data };
+
+  simModule.wordTransfers++;
+  simModule.Transfer(bus, 2);
+  return (uint16_t)((bus[0] << 8) | bus[1]);
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+  simModule.blockTransfers++;
+  simModule.Transfer((uint8_t *)buf, count);
+}
@@ -0,0 +1,54 @@
+/* Module simulated behind the SPI bus: it drives the data ready pin, takes
+   the command clocked in, then returns the scripted answer. The bytes of a
+   16-bit word are clocked MSB first, as by the real module. The answer is
+   either set before each command or returned by a responder.              */
+#ifndef SIM_SPI_MODULE_H
+#define SIM_SPI_MODULE_H
+
+#include <string>
+#include "sim_arduino.h"
+
+#define SIM_PIN_DATA_READY  2
+#define SIM_PIN_CS          3
+#define SIM_PIN_RESET       4
+#define SIM_PIN_WAKEUP      5
+
+class SimSpiModule : public SimPins {
+  public:
+    typedef enum {
+      SIM_RESET,                         // held in reset
+      SIM_IDLE,                          // waiting for a command
+      SIM_COMMAND,                       // receiving a command
+      SIM_BUSY,                          // processing the command
+      SIM_ANSWER,                        // sending the answer
+      SIM_DONE,                          // answer sent, until deselected
+    } SimState_t;
+
+    SimState_t state;
+    bool selected;
+    std::string command;                 // last command received
+    std::string answer;                  // answer to the next command
+    std::string (*respond)(const std::string &command); // answers, if set
+    uint32_t commands;                   // commands received
+    uint32_t latency;                    // processing time of a command, ms
+    uint32_t blockTransfers;             // calls to transfer(buf, count)
+    uint32_t wordTransfers;              // calls to transfer16()
+    uint32_t readyReads;                 // reads of the data ready pin
+
+    SimSpiModule();
+    void ResetCounters(void);
+    virtual int Read(uint32_t pin);
+    virtual void Write(uint32_t pin, uint32_t value);
+    void Transfer(uint8_t *bus, size_t count);
+
+  private:
+    std::string sending;                 // answer being sent, even length
+    size_t pos;                          // next byte of it to send
+    uint32_t readyAt;                    // micros() when the answer is ready
+
+    void StartAnswer(const std::string &data);
+};
+
+extern SimSpiModule simModule;
+
+#endif
@@ -0,0 +1,54 @@
+/* Host stand-in of the Arduino core: only what the drivers use. Time is the
+   host clock, the pins and the buses are simulated by the tests.           */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* As newlib's sys/cdefs.h on the target */
+#ifndef _Static_assert
+  #define _Static_assert(x, y)    static_assert(x, y)
+#endif
+
+#define HIGH              1
+#define LOW               0
+#define INPUT             0
+#define OUTPUT            1
+#define CHANGE            2
+#define NOT_AN_INTERRUPT  (-1)
+
+/* No pin interrupt: the drivers poll the pins */
+#define digitalPinToInterrupt(p)  NOT_AN_INTERRUPT
+#define UNUSED(x)                 ((void)(x))
+#define __WFI()                   do {} while (0)
+
+void pinMode(uint32_t pin, uint32_t mode);
+void digitalWrite(uint32_t pin, uint32_t value);
+int digitalRead(uint32_t pin);
+void attachInterrupt(uint32_t irq, void (*handler)(void), uint32_t mode);
+void detachInterrupt(uint32_t irq);
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+/* Serial port over a host file descriptor, such as a pseudo-terminal */
+class HardwareSerial {
+  public:
+    int fd;
+
+    HardwareSerial(int fd = -1) : fd(fd) {}
+    void begin(unsigned long baud);
+    void end(void);
+    int available(void);
+    int read(void);
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    void flush(void);
+};
+
+#endif
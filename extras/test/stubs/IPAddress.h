@@ -0,0 +1,46 @@
+/* Host stand-in of the Arduino IPAddress class */
+#ifndef IPADDRESS_H
+#define IPADDRESS_H
+
+#include <stdint.h>
+
+class IPAddress {
+  private:
+    uint8_t bytes[4];
+
+  public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0)
+    {
+      bytes[0] = a;
+      bytes[1] = b;
+      bytes[2] = c;
+      bytes[3] = d;
+    }
+    IPAddress(const uint8_t *address)
+    {
+      for (int i = 0; i < 4; i++) {
+        bytes[i] = address[i];
+      }
+    }
+    uint8_t operator[](int index) const
+    {
+      return bytes[index];
+    }
+    bool operator==(const IPAddress &other) const
+    {
+      for (int i = 0; i < 4; i++) {
+        if (bytes[i] != other.bytes[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+    bool operator!=(const IPAddress &other) const
+    {
+      return !(*this == other);
+    }
+};
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+#endif
@@ -0,0 +1,34 @@
+/* Host stand-in of the Arduino SPI library, the transfers are served by the
+   simulated module of the tests.                                           */
+#ifndef SPI_H
+#define SPI_H
+
+#include "Arduino.h"
+
+#define MSBFIRST   1
+#define SPI_MODE0  0
+
+class SPISettings {
+  public:
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+    {
+      UNUSED(clock);
+      UNUSED(bitOrder);
+      UNUSED(dataMode);
+    }
+};
+
+class SPIClass {
+  public:
+    void begin(void) {}
+    void end(void) {}
+    void beginTransaction(SPISettings settings)
+    {
+      UNUSED(settings);
+    }
+    void endTransaction(void) {}
+    uint16_t transfer16(uint16_t data);
+    void transfer(void *buf, size_t count);
+};
+
+#endif
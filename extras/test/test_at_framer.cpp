@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    test_at_framer.cpp
+  * @brief   Host unit tests of the framer of the AT answers: the answers are
+  *          fed split at every position, as IO_Receive may return them.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include "at_framer.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+/* Status of an answer fed in two parts, split after split bytes */
+static AT_FrameStatus_t feedSplit(AtFramerClass &framer, const char *answer, size_t split)
+{
+  size_t len = strlen(answer);
+
+  framer.Reset();
+  framer.Feed((const uint8_t *)answer, split);
+  return framer.Feed((const uint8_t *)answer + split, len - split);
+}
+
+/* Status of an answer fed one byte at a time */
+static AT_FrameStatus_t feedBytes(AtFramerClass &framer, const char *answer)
+{
+  AT_FrameStatus_t status = AT_FRAME_PENDING;
+
+  framer.Reset();
+  for (size_t i = 0; answer[i] != '\0'; i++) {
+    status = framer.Feed((const uint8_t *)answer + i, 1);
+  }
+  return status;
+}
+
+/* The answer must have the same status wherever it is split */
+static void checkAllSplits(const char *answer, AT_FrameStatus_t expected)
+{
+  AtFramerClass framer;
+  size_t len = strlen(answer);
+
+  for (size_t split = 0; split <= len; split++) {
+    if (feedSplit(framer, answer, split) != expected) {
+      printf("split at %u of \"%s\" failed\n", (unsigned)split, answer);
+      failures++;
+    }
+  }
+  CHECK(feedBytes(framer, answer) == expected);
+}
+
+static void testEmptyInput(void)
+{
+  AtFramerClass framer;
+
+  CHECK(framer.Status() == AT_FRAME_PENDING);
+  CHECK(framer.Feed((const uint8_t *)"", 0) == AT_FRAME_PENDING);
+  CHECK(framer.Feed(NULL, 0) == AT_FRAME_PENDING);
+}
+
+static void testSplitOk(void)
+{
+  checkAllSplits("\r\n192.168.1.10\r\nOK\r\n> ", AT_FRAME_OK);
+  checkAllSplits("\r\nOK\r\n> ", AT_FRAME_OK);
+  /* Fewer bytes than the OK string, or its start only */
+  checkAllSplits("\r\nOK\r\n", AT_FRAME_PENDING);
+  checkAllSplits("\r\nOK", AT_FRAME_PENDING);
+}
+
+static void testSplitPrompt(void)
+{
+  AtFramerClass framer;
+
+  /* The prompt is the last 2 bytes of the answer */
+  framer.Feed((const uint8_t *)"\r\n-52\r\nOK\r\n>", 12);
+  CHECK(framer.Status() == AT_FRAME_PENDING);
+  CHECK(framer.Feed((const uint8_t *)" ", 1) == AT_FRAME_OK);
+
+  /* A prompt alone is not the end of an answer */
+  checkAllSplits("> ", AT_FRAME_PENDING);
+  checkAllSplits("\r\n> ", AT_FRAME_PENDING);
+}
+
+static void testErrorInPayload(void)
+{
+  AtFramerClass framer;
+
+  /* Data which contain an ERROR line, then the OK string */
+  checkAllSplits("\r\nGET /\r\nERROR 404\r\n\r\nOK\r\n> ", AT_FRAME_OK);
+  /* Data which contain the OK string, followed by more data */
+  checkAllSplits("\r\nOK\r\n> more\r\nOK\r\n> ", AT_FRAME_OK);
+  checkAllSplits("\r\nOK\r\n> more", AT_FRAME_PENDING);
+  /* An ERROR line without the OK string */
+  checkAllSplits("\r\nERROR: Invalid command\r\n> ", AT_FRAME_ERROR);
+  checkAllSplits("\r\nERR\r\nERROR", AT_FRAME_ERROR);
+  checkAllSplits("\r\n\r\r\nERROR", AT_FRAME_ERROR);
+
+  /* Reset forgets the ERROR line */
+  framer.Feed((const uint8_t *)"\r\nERROR", 7);
+  CHECK(framer.Status() == AT_FRAME_ERROR);
+  framer.Reset();
+  CHECK(framer.Status() == AT_FRAME_PENDING);
+}
+
+int main(void)
+{
+  testEmptyInput();
+  testSplitOk();
+  testSplitPrompt();
+  testErrorInPayload();
+
+  if (failures != 0) {
+    printf("test_at_framer: %d failures\n", failures);
+    return 1;
+  }
+  printf("test_at_framer: OK\n");
+  return 0;
+}
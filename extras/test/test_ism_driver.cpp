@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    test_ism_driver.cpp
+  * @brief   Host unit tests of the AT command layer against the module
+  *          simulated behind the SPI bus.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "ISM43362_M3G_L44_driver.h"
+#include "sim_spi_module.h"
+#include "sim_module_answers.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+static SPIClass spi;
+static std::vector<std::string> commands;
+
+/* Record the commands, then answer them */
+static std::string recordAndAnswer(const std::string &command)
+{
+  commands.push_back(command);
+  return simAnswer(command);
+}
+
+static void startModule(IsmDrvClass &drv, const char *firmware)
+{
+  simFirmware = firmware;
+  CHECK(drv.ES_WIFI_Init() == ES_WIFI_STATUS_OK);
+  CHECK(strcmp(drv.ES_WIFI_GetFWRevID(), firmware) == 0);
+  commands.clear();
+}
+
+/* Commands sent to write data to a socket */
+static std::vector<std::string> writeCommands(const std::vector<std::string> &all)
+{
+  std::vector<std::string> writes;
+
+  for (size_t i = 0; i < all.size(); i++) {
+    if ((all[i][0] == 'S') && (all[i][1] != '2')) {
+      writes.push_back(all[i]);
+    }
+  }
+  return writes;
+}
+
+static void testWriteWithLength(void)
+{
+  IsmDrvClass drv(&spi, SIM_PIN_CS, SIM_PIN_DATA_READY, SIM_PIN_RESET, SIM_PIN_WAKEUP);
+  uint8_t data[] = "0123456789";
+  std::vector<std::string> writes;
+  size_t sent;
+
+  startModule(drv, "C3.5.2.5.STM");
+  /* The length is given with the data */
+  drv.ES_WIFI_SendResp(0, data, 10, &sent, 1000);
+  CHECK(sent == 10);
+  writes = writeCommands(commands);
+  CHECK(writes.size() == 1);
+  CHECK(writes[0] == std::string("S3=0010\r0123456789"));
+}
+
+static void testWriteOldFirmware(void)
+{
+  IsmDrvClass drv(&spi, SIM_PIN_CS, SIM_PIN_DATA_READY, SIM_PIN_RESET, SIM_PIN_WAKEUP);
+  uint8_t data[] = "0123456789";
+  std::vector<std::string> writes;
+  size_t sent;
+
+  startModule(drv, "C3.5.2.3.STM");
+  /* The packet size is set before the data */
+  drv.ES_WIFI_SendResp(0, data, 10, &sent, 1000);
+  CHECK(sent == 10);
+  writes = writeCommands(commands);
+  CHECK(writes.size() == 2);
+  CHECK(writes[0] == std::string("S1=10\r"));
+  CHECK(writes[1] == std::string("S0\r0123456789\n"));
+
+  /* Not again for the same size */
+  commands.clear();
+  drv.ES_WIFI_SendResp(0, data, 10, &sent, 1000);
+  CHECK(writeCommands(commands).size() == 1);
+}
+
+int main(void)
+{
+  simPins = &simModule;
+  simModule.respond = recordAndAnswer;
+  testWriteWithLength();
+  testWriteOldFirmware();
+
+  if (failures != 0) {
+    printf("test_ism_driver: %d failures\n", failures);
+    return 1;
+  }
+  printf("test_ism_driver: OK\n");
+  return 0;
+}
@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    test_parsers.cpp
+  * @brief   Host unit and property tests of the decoders of numbers, IP and
+  *          MAC addresses: they must give the results of the former ones,
+  *          malformed input included.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* The decoders are private members of the driver */
+#define private public
+#include "ISM43362_M3G_L44_driver.h"
+#undef private
+#include "ref_parsers.h"
+
+#define RANDOM_STRINGS  200000
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+static SPIClass spi;
+
+static bool sameIP(IsmDrvClass &drv, const char *str, const uint8_t *expected)
+{
+  uint8_t ip[4] = {0xAA, 0xAA, 0xAA, 0xAA};
+
+  drv.ParseIP((char *)str, ip);
+  return memcmp(ip, expected, 4) == 0;
+}
+
+static void testExamples(IsmDrvClass &drv)
+{
+  const uint8_t ip[4] = {192, 168, 1, 10};
+  const uint8_t partial[4] = {10, 0, 0xAA, 0xAA};
+  const uint8_t mac[6] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E};
+  uint8_t out[6];
+  uint8_t cnt;
+
+  CHECK(sameIP(drv, "192.168.1.10", ip));
+  CHECK(sameIP(drv, "192-168-1-10", ip));
+  CHECK(sameIP(drv, "192.168.1.10,255.255.255.0", ip));
+  CHECK(sameIP(drv, "192.168.1.10\r\nOK", ip));
+  CHECK(sameIP(drv, "10.0,1.2", partial));
+
+  drv.ParseMAC((char *)"00:1A:2b:3C:4d:5E,", out);
+  CHECK(memcmp(out, mac, 6) == 0);
+
+  CHECK(drv.ParseNumber((char *)"-52,", &cnt) == -52);
+  CHECK(cnt == 3);
+  CHECK(drv.ParseNumber((char *)"x", &cnt) == 0);
+  CHECK(cnt == 0);
+  CHECK(drv.ParseHexNumber((char *)"fF0a:", &cnt) == 0xFF0A);
+  CHECK(cnt == 4);
+}
+
+/* Random strings made of the characters met in the answers */
+static void randomString(char *str, size_t size)
+{
+  static const char alphabet[] = "0123456789abcdefABCDEF.:-,xg \r\n";
+  size_t len = rand() % size;
+
+  for (size_t i = 0; i < len; i++) {
+    str[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+  }
+  str[len] = '\0';
+}
+
+static void checkAgainstReference(IsmDrvClass &drv, const char *str)
+{
+  uint8_t cnt, refCnt;
+  uint8_t out[6], ref[6];
+
+  CHECK(drv.ParseNumber((char *)str, &cnt) == RefParseNumber(str, &refCnt));
+  CHECK(cnt == refCnt);
+  CHECK(drv.ParseHexNumber((char *)str, &cnt) == RefParseHexNumber(str, &refCnt));
+  CHECK(cnt == refCnt);
+
+  memset(out, 0xAA, sizeof(out));
+  memset(ref, 0xAA, sizeof(ref));
+  drv.ParseMAC((char *)str, out);
+  RefParseMAC(str, ref);
+  CHECK(memcmp(out, ref, sizeof(out)) == 0);
+
+  memset(out, 0xAA, sizeof(out));
+  memset(ref, 0xAA, sizeof(ref));
+  drv.ParseIP((char *)str, out);
+  RefParseIP(str, ref);
+  CHECK(memcmp(out, ref, sizeof(out)) == 0);
+}
+
+static void testProperties(IsmDrvClass &drv)
+{
+  char str[64];
+  char digits[600];
+  int before = failures;
+
+  for (int c = 0; c < 256; c++) {
+    CHECK(drv.Hex2Num((char)c) == RefHex2Num((char)c));
+  }
+  srand(1);
+  for (int i = 0; (i < RANDOM_STRINGS) && (failures == before); i++) {
+    randomString(str, sizeof(str));
+    checkAgainstReference(drv, str);
+    if (failures != before) {
+      printf("differs on \"%s\"\n", str);
+    }
+  }
+
+  /* More digits than the 8-bit count of the characters parsed */
+  memset(digits, '7', sizeof(digits) - 1);
+  digits[sizeof(digits) - 1] = '\0';
+  checkAgainstReference(drv, digits);
+  digits[300] = '.';
+  checkAgainstReference(drv, digits);
+}
+
+int main(void)
+{
+  IsmDrvClass drv(&spi, 3, 2, 4, 5);
+
+  testExamples(drv);
+  testProperties(drv);
+
+  if (failures != 0) {
+    printf("test_parsers: %d failures\n", failures);
+    return 1;
+  }
+  printf("test_parsers: OK\n");
+  return 0;
+}
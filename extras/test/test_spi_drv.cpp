@@ -0,0 +1,213 @@
+/**
+  ******************************************************************************
+  * @file    test_spi_drv.cpp
+  * @brief   Host unit tests of the SPI driver against a simulated module:
+  *          block transfers, padding, scattered buffers and non-blocking
+  *          exchanges.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "spi_drv.h"
+#include "sim_spi_module.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+static SPIClass spi;
+
+/* Bytes 0 to 255 in turn, without the 0x15 of the padding */
+static std::string pattern(size_t len)
+{
+  std::string data;
+
+  for (size_t i = 0; i < len; i++) {
+    data += (char)((i % 255 == 0x15) ? 'x' : (i % 255));
+  }
+  return data;
+}
+
+/* Receive the answer of the command sent, to send the next one */
+static void finish(SpiDrvClass &drv)
+{
+  uint8_t buffer[64];
+
+  simModule.answer = "\r\nOK\r\n> ";
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 100) == 8);
+}
+
+static void testInit(SpiDrvClass &drv)
+{
+  CHECK(drv.IO_Init(IO_INIT_COLD) == 0);
+  CHECK(drv.IO_GetSpeed() == SPI_CLOCK_MAX);
+  CHECK(simModule.state == SimSpiModule::SIM_IDLE);
+}
+
+static void testSendPadding(SpiDrvClass &drv)
+{
+  uint8_t cmd[] = "AT\r";
+
+  simModule.ResetCounters();
+  CHECK(drv.IO_Send(cmd, 3, 100) == 3);
+  CHECK(simModule.command == std::string("AT\r\n"));
+  CHECK(simModule.blockTransfers == 1);
+  CHECK(simModule.wordTransfers == 0);
+  finish(drv);
+}
+
+static void testSendSegments(SpiDrvClass &drv)
+{
+  std::string data = pattern(1200);
+  IO_Segment_t seg[3] = {
+    {(uint8_t *) &data[0], 7},
+    {(uint8_t *) &data[7], 600},
+    {(uint8_t *) &data[607], 593},
+  };
+
+  simModule.ResetCounters();
+  CHECK(drv.IO_SendSegments(seg, 3, 100) == 1200);
+  CHECK(simModule.command == data);
+  CHECK(simModule.blockTransfers == (1200 + SPI_BLOCK_SIZE - 1) / SPI_BLOCK_SIZE);
+  finish(drv);
+}
+
+/* Send a command then receive its answer in the given buffers */
+static int16_t exchange(SpiDrvClass &drv, const std::string &answer, IO_Segment_t *seg,
+                        uint8_t count, uint32_t timeout = 100)
+{
+  uint8_t cmd[] = "C?\r";
+
+  simModule.answer = answer;
+  if (drv.IO_Send(cmd, 3, 100) != 3) {
+    return -1;
+  }
+  simModule.ResetCounters();
+  return drv.IO_ReceiveSegments(seg, count, timeout);
+}
+
+static void testReceive(SpiDrvClass &drv)
+{
+  std::string answer = "\r\n" + pattern(1001) + "\r\nOK\r\n> ";
+  static uint8_t buffer[2000];
+  IO_Segment_t seg = {buffer, sizeof(buffer)};
+
+  /* Odd length: the 0x15 padding is dropped */
+  CHECK(exchange(drv, answer, &seg, 1) == (int16_t)answer.size());
+  CHECK(memcmp(buffer, answer.data(), answer.size()) == 0);
+  CHECK(simModule.wordTransfers == 0);
+  CHECK(simModule.blockTransfers <= answer.size() / SPI_BLOCK_SIZE + 2);
+}
+
+static void testReceiveSplitWord(SpiDrvClass &drv)
+{
+  std::string answer = "\r\n" + pattern(300) + "\r\nOK\r\n> ";
+  static uint8_t buffer[3][400];
+  IO_Segment_t seg[3] = {
+    {buffer[0], 5},
+    {buffer[1], 7},
+    {buffer[2], 400},
+  };
+
+  /* A word is split between the buffers */
+  CHECK(exchange(drv, answer, seg, 3) == (int16_t)answer.size());
+  CHECK(memcmp(buffer[0], answer.data(), 5) == 0);
+  CHECK(memcmp(buffer[1], answer.data() + 5, 7) == 0);
+  CHECK(memcmp(buffer[2], answer.data() + 12, answer.size() - 12) == 0);
+}
+
+static void testReceiveContinued(SpiDrvClass &drv)
+{
+  std::string answer = "\r\n" + pattern(100) + "\r\nOK\r\n> ";
+  uint8_t buffer[200];
+  IO_Segment_t seg = {buffer, 64};
+  int16_t len;
+
+  /* A full buffer stops the reception, the next one continues it */
+  CHECK(exchange(drv, answer, &seg, 1) == 64);
+  len = drv.IO_Receive(buffer + 64, 0, 100);
+  CHECK(len == (int16_t)answer.size() - 64);
+  CHECK(memcmp(buffer, answer.data(), answer.size()) == 0);
+}
+
+static void testReceiveTimeout(SpiDrvClass &drv)
+{
+  uint8_t buffer[16];
+  IO_Segment_t seg = {buffer, sizeof(buffer)};
+  IO_Stats_t stats;
+
+  drv.IO_ResetStats();
+  simModule.latency = 1000;
+  CHECK(exchange(drv, "\r\nOK\r\n> ", &seg, 1, 20) == 0);
+  drv.IO_GetStats(&stats);
+  CHECK(stats.Timeouts == 1);
+  simModule.latency = 0;
+  simModule.state = SimSpiModule::SIM_IDLE;
+}
+
+static void testNonBlocking(SpiDrvClass &drv)
+{
+  uint8_t cmd[] = "C?\r";
+  uint8_t buffer[64];
+  uint32_t polls = 0;
+  IO_State_t state;
+
+  /* The caller keeps running while the module processes the command */
+  simModule.latency = 30;
+  simModule.answer = "\r\n-52\r\nOK\r\n> ";
+  CHECK(drv.IO_Start(cmd, 3, buffer, sizeof(buffer), 1000) == 0);
+  CHECK(drv.IO_Start(cmd, 3, buffer, sizeof(buffer), 1000) == -1);
+  while ((state = drv.IO_Poll()) == IO_STATE_WAIT) {
+    polls++;
+  }
+  CHECK(state == IO_STATE_DONE);
+  CHECK(polls > 1);
+  CHECK(simModule.command == std::string("C?\r\n"));
+  CHECK(drv.IO_Complete() == 13);
+  CHECK(memcmp(buffer, "\r\n-52\r\nOK\r\n> ", 13) == 0);
+
+  /* IO_Complete waits for the end of the exchange */
+  CHECK(drv.IO_Start(cmd, 3, buffer, sizeof(buffer), 1000) == 0);
+  CHECK(drv.IO_Poll() == IO_STATE_WAIT);
+  CHECK(drv.IO_Complete() == 13);
+
+  /* The answer comes too late */
+  simModule.latency = 1000;
+  CHECK(drv.IO_Start(cmd, 3, buffer, sizeof(buffer), 20) == 0);
+  while ((state = drv.IO_Poll()) == IO_STATE_WAIT) {
+  }
+  CHECK(state == IO_STATE_ERROR);
+  CHECK(drv.IO_Complete() == -1);
+  CHECK(drv.IO_Complete() == -1);
+  simModule.latency = 0;
+  simModule.state = SimSpiModule::SIM_IDLE;
+}
+
+int main(void)
+{
+  SpiDrvClass drv(&spi, SIM_PIN_CS, SIM_PIN_DATA_READY, SIM_PIN_RESET, SIM_PIN_WAKEUP);
+
+  simPins = &simModule;
+  testInit(drv);
+  testSendPadding(drv);
+  testSendSegments(drv);
+  testReceive(drv);
+  testReceiveSplitWord(drv);
+  testReceiveContinued(drv);
+  testReceiveTimeout(drv);
+  testNonBlocking(drv);
+
+  if (failures != 0) {
+    printf("test_spi_drv: %d failures\n", failures);
+    return 1;
+  }
+  printf("test_spi_drv: OK\n");
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+  ******************************************************************************
+  * @file    test_uart_drv.cpp
+  * @brief   Host unit tests of the UART driver through a pseudo-terminal: the
+  *          test plays the module on the master side.
+  ******************************************************************************
+  */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <string>
+#include "uart_drv.h"
+#include "sim_arduino.h"
+
+#define PIN_RESET   4
+#define PIN_WAKEUP  5
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+/* Module side of the pseudo-terminal: it sends its prompt once reset */
+class PtyModule : public SimPins {
+  public:
+    int master;
+
+    virtual int Read(uint32_t pin)
+    {
+      UNUSED(pin);
+      return LOW;
+    }
+    virtual void Write(uint32_t pin, uint32_t value)
+    {
+      if ((pin == PIN_RESET) && (value == HIGH)) {
+        Send("\r\n> ");
+      }
+    }
+    void Send(const std::string &data)
+    {
+      CHECK(write(master, data.data(), data.size()) == (ssize_t)data.size());
+    }
+    std::string Receive(void)
+    {
+      char buffer[256];
+      ssize_t len;
+
+      usleep(1000);
+      len = read(master, buffer, sizeof(buffer));
+      return std::string(buffer, (len > 0) ? len : 0);
+    }
+};
+
+static PtyModule module;
+
+static int openPty(void)
+{
+  struct termios tio;
+  int slave;
+
+  module.master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((module.master < 0) || (grantpt(module.master) != 0) || (unlockpt(module.master) != 0)) {
+    return -1;
+  }
+  fcntl(module.master, F_SETFL, O_NONBLOCK);
+  slave = open(ptsname(module.master), O_RDWR | O_NOCTTY);
+  if (slave < 0) {
+    return -1;
+  }
+  /* Bytes go through unchanged, '\r' included */
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+  return slave;
+}
+
+/* Send a command, check that the module gets it, then answer it */
+static void command(UARTDrvClass &drv, const char *cmd, const std::string &answer)
+{
+  CHECK(drv.IO_Send((uint8_t *)cmd, strlen(cmd), 100) == (int16_t)strlen(cmd));
+  CHECK(module.Receive() == std::string(cmd));
+  module.Send(answer);
+}
+
+static void testReceive(UARTDrvClass &drv)
+{
+  std::string answer = "\r\nISM43362-M3G-L44-UART,C3.5.2.5.STM\r\nOK\r\n> ";
+  uint8_t buffer[256];
+
+  command(drv, "I?\r", answer);
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 100) == (int16_t)answer.size());
+  CHECK(memcmp(buffer, answer.data(), answer.size()) == 0);
+}
+
+static void testPromptInData(UARTDrvClass &drv)
+{
+  std::string answer = "\r\nline\r\n> more\r\nOK\r\n> ";
+  uint8_t buffer[256];
+
+  /* The prompt alone does not end the answer */
+  command(drv, "R0\r", answer);
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 100) == (int16_t)answer.size());
+}
+
+static void testError(UARTDrvClass &drv)
+{
+  std::string answer = "\r\nERROR: Invalid command\r\n> ";
+  uint8_t buffer[256];
+
+  command(drv, "ZZ\r", answer);
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 100) == (int16_t)answer.size());
+}
+
+static void testSegments(UARTDrvClass &drv)
+{
+  std::string answer = "\r\n0123456789\r\nOK\r\n> ";
+  uint8_t head[5];
+  uint8_t tail[64];
+  IO_Segment_t seg[2] = {{head, sizeof(head)}, {tail, sizeof(tail)}};
+
+  command(drv, "R0\r", answer);
+  CHECK(drv.IO_ReceiveSegments(seg, 2, 100) == (int16_t)answer.size());
+  CHECK(memcmp(head, answer.data(), 5) == 0);
+  CHECK(memcmp(tail, answer.data() + 5, answer.size() - 5) == 0);
+}
+
+static void testPartialTimeout(UARTDrvClass &drv)
+{
+  uint8_t buffer[256];
+  IO_Stats_t stats;
+
+  /* The bytes received before the timeout are returned */
+  drv.IO_ResetStats();
+  command(drv, "R0\r", "\r\npartial");
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 50) == 9);
+  CHECK(memcmp(buffer, "\r\npartial", 9) == 0);
+  drv.IO_GetStats(&stats);
+  CHECK(stats.Timeouts == 1);
+  CHECK(stats.BytesReceived == 9);
+
+  /* Nothing at all */
+  CHECK(drv.IO_Send((uint8_t *)"R0\r", 3, 100) == 3);
+  CHECK(drv.IO_Receive(buffer, sizeof(buffer), 50) == 0);
+}
+
+int main(void)
+{
+  int slave = openPty();
+
+  if (slave < 0) {
+    printf("test_uart_drv: no pseudo-terminal\n");
+    return 1;
+  }
+
+  HardwareSerial serial(slave);
+  UARTDrvClass drv(&serial, PIN_RESET, PIN_WAKEUP);
+
+  simPins = &module;
+  CHECK(drv.IO_Init(IO_INIT_COLD) == 0);
+  CHECK(drv.IO_GetSpeed() == UART_BAUDRATE);
+  testReceive(drv);
+  testPromptInData(drv);
+  testError(drv);
+  testSegments(drv);
+  testPartialTimeout(drv);
+
+  if (failures != 0) {
+    printf("test_uart_drv: %d failures\n", failures);
+    return 1;
+  }
+  printf("test_uart_drv: OK\n");
+  return 0;
+}
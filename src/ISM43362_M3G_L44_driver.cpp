@@ -47,18 +47,25 @@
 /* Includes ------------------------------------------------------------------*/
 #include "ISM43362_M3G_L44_driver.h"
 
-#if (ES_WIFI_PAYLOAD_SIZE + AT_ERROR_STRING_LEN) > ES_WIFI_DATA_SIZE
-  #warning "ES_WIFI_PAYLOAD_SIZE is higer than ES_WIFI_DATA_SIZE this could cause overflow!"
-#endif
-
 _Static_assert((ES_WIFI_DATA_SIZE & 1) == 0, "ES_WIFI_DATA_SIZE have to be even!");
-
-#define CHARISHEXNUM(x)                 (((x) >= '0' && (x) <= '9') || \
-                                         ((x) >= 'a' && (x) <= 'f') || \
-                                         ((x) >= 'A' && (x) <= 'F'))
-
-#define CHARISNUM(x)                    ((x) >= '0' && (x) <= '9')
-#define CHAR2NUM(x)                     ((x) - '0')
+_Static_assert((ES_WIFI_JOURNAL_SIZE & (ES_WIFI_JOURNAL_SIZE - 1)) == 0,
+               "ES_WIFI_JOURNAL_SIZE have to be a power of 2!");
+_Static_assert(ES_WIFI_JOURNAL_SIZE <= 32768, "ES_WIFI_JOURNAL_SIZE have to fit in 16 bits!");
+
+/* 0x10 | value of the hexadecimal digits, 0 for the other characters     */
+static const uint8_t HexTable[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x00 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x10 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x20 */
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0, 0, 0, 0, 0, 0,  /* 0x30 */
+  0, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x40 */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x50 */
+  0, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0, 0, 0, 0, 0, 0, 0, 0, 0,  /* 0x60 */
+  /* 0x70 to 0xFF: 0 */
+};
+
+/* One unsigned comparison instead of two                                    */
+#define CHARISNUM(x)                    ((uint8_t)((x) - '0') < 10)
 
 //#define DEBUG
 #ifdef DEBUG
@@ -89,10 +96,26 @@ IsmDrvClass::IsmDrvClass(SPIClass *SPIx, uint8_t cs, uint8_t spiIRQ,
 {
   /* Call Spi constructor                                                    */
   Drv = new SpiDrvClass(SPIx, cs, spiIRQ, reset, wakeup);
+  commMode = COMM_SPI;
   for (int i = 0; i < MAX_SOCK_NUM; i++) {
     sockState[i] = SOCKET_FREE;
+    AT_ClearBuffers(i);
   }
+  Cmd.Init(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE);
   currentSock = 0;
+  warmStart = (ES_WIFI_WARM_START != 0);
+  bootTime = 0;
+  writeWithLength = false;
+  AT_InvalidateParams();
+  AT_InitTimeouts();
+#if ES_WIFI_JOURNAL_SIZE
+  journalCount = 0;
+#endif
+  ES_WIFI_ResetLatency();
+#if ES_WIFI_RECOVERY
+  memset(&Recovery, 0, sizeof(Recovery));
+  Recovery.Enabled = true;
+#endif
 }
 
 /**
@@ -105,19 +128,30 @@ IsmDrvClass::IsmDrvClass(SPIClass *SPIx, uint8_t cs, uint8_t spiIRQ,
 IsmDrvClass::IsmDrvClass(HardwareSerial *UARTx,  uint8_t reset, uint8_t wakeup)
 {
   /* Call UART constructor                                                   */
-  /* TODO: neither developed nor tested on DISCO L475VG IOT because the WiFi
-    module is only connected by SPI. An UART driver needs to be added.
-    This constructor is given as example. Maybe it needs to be adapted.
+  /* Not tested on DISCO L475VG IOT because the WiFi module is only connected
+    by SPI.
   */
-  UNUSED(UARTx);
-  UNUSED(reset);
-  UNUSED(wakeup);
-
-  // Drv = new UARTDrvClass(UARTx, reset, wakeup);
+  Drv = new UARTDrvClass(UARTx, reset, wakeup);
+  commMode = COMM_UART;
   for (int i = 0; i < MAX_SOCK_NUM; i++) {
     sockState[i] = SOCKET_FREE;
+    AT_ClearBuffers(i);
   }
+  Cmd.Init(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE);
   currentSock = 0;
+  warmStart = (ES_WIFI_WARM_START != 0);
+  bootTime = 0;
+  writeWithLength = false;
+  AT_InvalidateParams();
+  AT_InitTimeouts();
+#if ES_WIFI_JOURNAL_SIZE
+  journalCount = 0;
+#endif
+  ES_WIFI_ResetLatency();
+#if ES_WIFI_RECOVERY
+  memset(&Recovery, 0, sizeof(Recovery));
+  Recovery.Enabled = true;
+#endif
 }
 
 /**
@@ -141,10 +175,26 @@ IsmDrvClass::IsmDrvClass(uint8_t tx, uint8_t rx, uint8_t reset, uint8_t wakeup)
   UNUSED(wakeup);
 
   // Drv = new USBDrvClass(tx, rx, reset, wakeup);
+  commMode = COMM_USB_VCP;
   for (int i = 0; i < MAX_SOCK_NUM; i++) {
     sockState[i] = SOCKET_FREE;
+    AT_ClearBuffers(i);
   }
+  Cmd.Init(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE);
   currentSock = 0;
+  warmStart = (ES_WIFI_WARM_START != 0);
+  bootTime = 0;
+  writeWithLength = false;
+  AT_InvalidateParams();
+  AT_InitTimeouts();
+#if ES_WIFI_JOURNAL_SIZE
+  journalCount = 0;
+#endif
+  ES_WIFI_ResetLatency();
+#if ES_WIFI_RECOVERY
+  memset(&Recovery, 0, sizeof(Recovery));
+  Recovery.Enabled = true;
+#endif
 }
 
 
@@ -155,15 +205,7 @@ IsmDrvClass::IsmDrvClass(uint8_t tx, uint8_t rx, uint8_t reset, uint8_t wakeup)
   */
 uint8_t IsmDrvClass::Hex2Num(char a)
 {
-  if (a >= '0' && a <= '9') {            /* Char is num */
-    return a - '0';
-  } else if (a >= 'a' && a <= 'f') {     /* Char is lowercase character A - Z (hex) */
-    return (a - 'a') + 10;
-  } else if (a >= 'A' && a <= 'F') {     /* Char is uppercase character A - Z (hex) */
-    return (a - 'A') + 10;
-  }
-
-  return 0;
+  return HexTable[(uint8_t)a] & 0x0F;   /* 0 if not an hexadecimal digit */
 }
 
 /**
@@ -176,14 +218,14 @@ uint32_t IsmDrvClass::ParseHexNumber(char *ptr, uint8_t *cnt)
 {
   uint32_t sum = 0;
   uint8_t i = 0;
+  uint8_t digit;
 
   if (ptr == NULL) {
     return 0;
   }
 
-  while (CHARISHEXNUM(*ptr)) {    /* Parse number */
-    sum <<= 4;
-    sum += Hex2Num(*ptr);
+  while ((digit = HexTable[(uint8_t)*ptr]) != 0) {    /* Parse number */
+    sum = (sum << 4) | (digit & 0x0F);
     ptr++;
     i++;
   }
@@ -203,7 +245,8 @@ uint32_t IsmDrvClass::ParseHexNumber(char *ptr, uint8_t *cnt)
 int32_t IsmDrvClass::ParseNumber(char *ptr, uint8_t *cnt)
 {
   uint8_t minus = 0, i = 0;
-  int32_t sum = 0;
+  uint32_t sum = 0;                     /* Wraps around on overflow */
+  uint8_t digit;
 
   if (ptr == NULL) {
     return 0;
@@ -214,8 +257,8 @@ int32_t IsmDrvClass::ParseNumber(char *ptr, uint8_t *cnt)
     ptr++;
     i++;
   }
-  while (CHARISNUM(*ptr)) {             /* Parse number */
-    sum = 10 * sum + CHAR2NUM(*ptr);
+  while ((digit = (uint8_t)(*ptr - '0')) < 10) {      /* Parse number */
+    sum = 10 * sum + digit;
     ptr++;
     i++;
   }
@@ -223,9 +266,9 @@ int32_t IsmDrvClass::ParseNumber(char *ptr, uint8_t *cnt)
     *cnt = i;
   }
   if (minus) {                          /* Minus detected */
-    return 0 - sum;
+    return (int32_t)(0 - sum);
   }
-  return sum;                           /* Return number */
+  return (int32_t)sum;                  /* Return number */
 }
 
 /**
@@ -236,72 +279,200 @@ int32_t IsmDrvClass::ParseNumber(char *ptr, uint8_t *cnt)
   */
 void IsmDrvClass::ParseMAC(char *ptr, uint8_t *arr)
 {
-  uint8_t hexnum = 0, hexcnt;
+  uint8_t hexnum = 0, hexcnt, value, digit;
+  char *p;
 
   if ((ptr == NULL) || (arr == NULL)) {
     return;
   }
 
-  while (* ptr) {
-    hexcnt = 1;
-    if (*ptr != ':') {
-      arr[hexnum++] = ParseHexNumber(ptr, &hexcnt);
+  /* Stop at the end of the address, the string does not need to be terminated */
+  while (hexnum < 6) {
+    if (*ptr == ':') {
+      ptr++;
+    } else if ((digit = HexTable[(uint8_t)*ptr]) != 0) {
+      /* As ParseHexNumber: the last 2 digits make the byte */
+      value = 0;
+      hexcnt = 0;
+      for (p = ptr; digit != 0; digit = HexTable[(uint8_t)*++p]) {
+        value = (value << 4) | (digit & 0x0F);
+        hexcnt++;
+      }
+      arr[hexnum++] = value;
+      ptr = ptr + hexcnt;
+    } else {
+      break;
     }
-    ptr = ptr + hexcnt;
   }
 }
 
 /**
-  * @brief  Parses and returns IP address.
+  * @brief  Parses and returns IP address, its bytes separated by '.' or '-'.
   * @param  ptr: pointer to string
   * @param  arr: pointer to IP array
   * @retval None.
   */
 void IsmDrvClass::ParseIP(char *ptr, uint8_t *arr)
 {
-  uint8_t hexnum = 0, hexcnt;
+  uint8_t hexnum = 0, hexcnt, value, digit;
+  char *p;
 
   if ((ptr == NULL) || (arr == NULL)) {
     return;
   }
 
-  while (* ptr) {
-    hexcnt = 1;
-    if (*ptr != '.') {
-      arr[hexnum++] = ParseNumber(ptr, &hexcnt);
+  /* Stop at the end of the address, the string does not need to be terminated */
+  while (hexnum < 4) {
+    if ((*ptr == '.') || (*ptr == '-')) {
+      ptr++;
+    } else if ((digit = (uint8_t)(*ptr - '0')) < 10) {
+      /* As ParseNumber, truncated to a byte */
+      value = 0;
+      hexcnt = 0;
+      for (p = ptr; digit < 10; digit = (uint8_t)(*++p - '0')) {
+        value = 10 * value + digit;
+        hexcnt++;
+      }
+      arr[hexnum++] = value;
+      ptr = ptr + hexcnt;
+    } else {
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Search a string in a field.
+  * @param  field: field to search in
+  * @param  str: string to search
+  * @retval true if the field contains the string.
+  */
+static bool FieldContains(const AT_Span_t *field, const char *str)
+{
+  uint16_t len = strlen(str);
+
+  for (uint16_t i = 0; i + len <= field->Len; i++) {
+    if (memcmp(field->Ptr + i, str, len) == 0) {
+      return true;
     }
-    ptr = ptr + hexcnt;
   }
+  return false;
 }
 
 /**
   * @brief  Parses Security type.
-  * @param  ptr: pointer to string
+  * @param  field: field to parse
   * @retval Encryption type.
   */
-ES_WIFI_SecurityType_t IsmDrvClass::ParseSecurity(char *ptr)
+ES_WIFI_SecurityType_t IsmDrvClass::ParseSecurity(const AT_Span_t *field)
 {
-  if (ptr == NULL) {
+  if (field == NULL) {
     return ES_WIFI_SEC_UNKNOWN;
   }
 
-  if (strstr(ptr, "Open")) {
+  if (FieldContains(field, "Open")) {
     return ES_WIFI_SEC_OPEN;
-  } else if (strstr(ptr, "WEP")) {
+  } else if (FieldContains(field, "WEP")) {
     return ES_WIFI_SEC_WEP;
-  } else if (strstr(ptr, "WPA WPA2")) {
+  } else if (FieldContains(field, "WPA WPA2")) {
     return ES_WIFI_SEC_WPA_WPA2;
-  } else if (strstr(ptr, "WPA2 TKIP")) {
+  } else if (FieldContains(field, "WPA2 TKIP")) {
     return ES_WIFI_SEC_WPA2_TKIP;
-  } else if (strstr(ptr, "WPA2")) {
+  } else if (FieldContains(field, "WPA2")) {
     return ES_WIFI_SEC_WPA2;
-  } else if (strstr(ptr, "WPA")) {
+  } else if (FieldContains(field, "WPA")) {
     return ES_WIFI_SEC_WPA;
   } else {
     return ES_WIFI_SEC_UNKNOWN;
   }
 }
 
+/**
+  * @brief  Parses a firmware revision such as "C3.5.2.5.STM".
+  * @param  ptr: pointer to string
+  * @retval revision as (major << 24) | (minor << 16) | (patch << 8) | build.
+  */
+uint32_t IsmDrvClass::AT_ParseFWRev(char *ptr)
+{
+  uint32_t rev = 0;
+  uint8_t cnt = 0;
+
+  while ((*ptr != '\0') && !CHARISNUM(*ptr)) {    /* Skip the prefix */
+    ptr++;
+  }
+  for (uint8_t i = 0; i < 4; i++) {
+    rev <<= 8;
+    if (CHARISNUM(*ptr)) {
+      rev |= (uint8_t)ParseNumber(ptr, &cnt);
+      ptr += cnt;
+      if (*ptr == '.') {
+        ptr++;
+      }
+    }
+  }
+  return rev;
+}
+
+/**
+  * @brief  Start iterating over the fields of an answer.
+  * @param  fields: iterator
+  * @param  pdata: pointer to the answer, left unchanged
+  * @param  len: length of the answer
+  * @retval None.
+  */
+void IsmDrvClass::AT_FieldsInit(AT_Fields_t *fields, char *pdata, uint16_t len)
+{
+  fields->Pos = pdata;
+  fields->End = pdata + len;
+  fields->Delimited = false;
+}
+
+/**
+  * @brief  Return the next field of an answer.
+  * @param  fields: iterator
+  * @param  delim: character separating the fields
+  * @param  field: returned field, may be empty
+  * @retval true if a field is returned, false at the end of the answer.
+  * @note   Fields are positional: unlike strtok, empty fields are returned and
+  *         the answer is not modified.
+  */
+bool IsmDrvClass::AT_NextField(AT_Fields_t *fields, char delim, AT_Span_t *field)
+{
+  char *next;
+
+  if (fields->Pos == NULL) {
+    return false;
+  }
+
+  field->Ptr = fields->Pos;
+  next = (char *)memchr(fields->Pos, delim, fields->End - fields->Pos);
+  if (next != NULL) {
+    field->Len = next - fields->Pos;
+    fields->Pos = next + 1;
+    fields->Delimited = true;
+  } else {
+    field->Len = fields->End - fields->Pos;
+    fields->Pos = NULL;
+    fields->Delimited = false;
+  }
+  return true;
+}
+
+/**
+  * @brief  Copy a field as strncpy() would do.
+  * @param  dest: destination string
+  * @param  size: size of the destination
+  * @param  field: field to copy
+  * @retval None.
+  */
+void IsmDrvClass::AT_CopyField(uint8_t *dest, uint16_t size, const AT_Span_t *field)
+{
+  uint16_t len = (field->Len < size) ? field->Len : size;
+
+  memcpy(dest, field->Ptr, len);
+  memset(dest + len, 0, size - len);
+}
+
 /**
   * @brief  Parses ES module informations and save them in the handle.
   * @param  ptr: pointer to string
@@ -309,71 +480,79 @@ ES_WIFI_SecurityType_t IsmDrvClass::ParseSecurity(char *ptr)
   */
 void IsmDrvClass::AT_ParseInfo(uint8_t *pdata)
 {
-  char *ptr;
+  AT_Fields_t fields;
+  AT_Span_t field;
+  char *end;
   uint8_t num = 0;
 
   if (pdata == NULL) {
     return;
   }
 
-  ptr = strtok((char *)pdata + 2, ",");
+  AT_FieldsInit(&fields, (char *)pdata + 2, strlen((char *)pdata + 2));
 
-  while (ptr != NULL) {
+  while (AT_NextField(&fields, ',', &field)) {
     switch (num++) {
       case 0:
-        strncpy((char *)EsWifiObj.Product_ID,  ptr, ES_WIFI_PRODUCT_ID_SIZE);
+        AT_CopyField(EsWifiObj.Product_ID, ES_WIFI_PRODUCT_ID_SIZE, &field);
         break;
 
       case 1:
-        strncpy((char *)EsWifiObj.FW_Rev,  ptr, ES_WIFI_FW_REV_SIZE);
+        AT_CopyField(EsWifiObj.FW_Rev, ES_WIFI_FW_REV_SIZE, &field);
         break;
 
       case 2:
-        strncpy((char *)EsWifiObj.API_Rev,  ptr, ES_WIFI_API_REV_SIZE);
+        AT_CopyField(EsWifiObj.API_Rev, ES_WIFI_API_REV_SIZE, &field);
         break;
 
       case 3:
-        strncpy((char *)EsWifiObj.Stack_Rev,  ptr, ES_WIFI_STACK_REV_SIZE);
+        AT_CopyField(EsWifiObj.Stack_Rev, ES_WIFI_STACK_REV_SIZE, &field);
         break;
 
       case 4:
-        strncpy((char *)EsWifiObj.RTOS_Rev,  ptr, ES_WIFI_RTOS_REV_SIZE);
+        AT_CopyField(EsWifiObj.RTOS_Rev, ES_WIFI_RTOS_REV_SIZE, &field);
         break;
 
       case 5:
-        EsWifiObj.CPU_Clock = ParseNumber(ptr, NULL);
+        EsWifiObj.CPU_Clock = ParseNumber(field.Ptr, NULL);
         break;
 
       case 6:
-        ptr = strtok(ptr, "\r");
-        strncpy((char *)EsWifiObj.Product_Name,  ptr, ES_WIFI_PRODUCT_NAME_SIZE);
+        /* Last field, followed by the status of the command */
+        end = (char *)memchr(field.Ptr, '\r', field.Len);
+        if (end != NULL) {
+          field.Len = end - field.Ptr;
+        }
+        AT_CopyField(EsWifiObj.Product_Name, ES_WIFI_PRODUCT_NAME_SIZE, &field);
         break;
 
       default: break;
     }
-    ptr = strtok(NULL, ",");
   }
 }
 
 /**
   * @brief  Parses Access point configuration.
-  * @param  pdata: pointer to string
+  * @param  line: line of the scan answer
   * @param  AP: Access point structure
   * @retval boolean, true if parse ok
   */
-bool IsmDrvClass::AT_ParseSingleAP(char *pdata, ES_WIFI_AP_t *AP)
+bool IsmDrvClass::AT_ParseSingleAP(const AT_Span_t *line, ES_WIFI_AP_t *AP)
 {
+  AT_Fields_t fields;
+  AT_Span_t field;
+  AT_Span_t skip;
+  char *end;
   uint8_t num = 0;
-  char *ptr;
   bool ret = false;
 
-  if (pdata == NULL) {
+  if (line == NULL) {
     return false;
   }
 
-  ptr = strtok(pdata, ",");
+  AT_FieldsInit(&fields, line->Ptr, line->Len);
 
-  while ((ptr != NULL) && (!ret)) {
+  while ((!ret) && AT_NextField(&fields, ',', &field)) {
     switch (num++) {
       case 0: /* Ignore index */
       case 4: /* Ignore Max Rate */
@@ -382,31 +561,42 @@ bool IsmDrvClass::AT_ParseSingleAP(char *pdata, ES_WIFI_AP_t *AP)
         break;
 
       case 1:
-        ptr[strlen(ptr) - 1] = 0;
-        strncpy((char *)AP->SSID,  ptr + 1, ES_WIFI_MAX_SSID_NAME_SIZE + 1);
+        /* Remove the quotes, the SSID may contain commas */
+        if ((field.Len > 0) && (field.Ptr[0] == '"')) {
+          field.Ptr++;
+          end = (char *)memchr(field.Ptr, '"', fields.End - field.Ptr);
+          if (end != NULL) {
+            field.Len = end - field.Ptr;
+            /* Skip up to the comma after the closing quote */
+            fields.Pos = end + 1;
+            AT_NextField(&fields, ',', &skip);
+          } else {
+            field.Len--;
+          }
+        }
+        AT_CopyField(AP->SSID, ES_WIFI_MAX_SSID_NAME_SIZE + 1, &field);
         break;
 
       case 2:
-        ParseMAC(ptr, AP->MAC);
+        ParseMAC(field.Ptr, AP->MAC);
         break;
 
       case 3:
-        AP->RSSI = ParseNumber(ptr, NULL);
+        AP->RSSI = ParseNumber(field.Ptr, NULL);
         break;
 
       case 6:
-        AP->Security = ParseSecurity(ptr);
+        AP->Security = ParseSecurity(&field);
         break;
 
       case 8:
-        AP->Channel = ParseNumber(ptr, NULL);
+        AP->Channel = ParseNumber(field.Ptr, NULL);
         ret = true;
         break;
 
       default:
         break;
     }
-    ptr = strtok(NULL, ",");
   }
   return ret;
 }
@@ -419,65 +609,65 @@ bool IsmDrvClass::AT_ParseSingleAP(char *pdata, ES_WIFI_AP_t *AP)
   */
 void IsmDrvClass::AT_ParseSystemConfig(char *pdata, ES_WIFI_SystemConfig_t *pConfig)
 {
+  AT_Fields_t fields;
+  AT_Span_t field;
   uint8_t num = 0;
-  char *ptr;
 
   if ((pdata == NULL) || (pConfig == NULL)) {
     return;
   }
 
-  ptr = strtok(pdata + 2, ",");
+  AT_FieldsInit(&fields, pdata + 2, strlen(pdata + 2));
 
-  while (ptr != NULL) {
+  while (AT_NextField(&fields, ',', &field)) {
     switch (num++) {
       case 0:
-        pConfig->Configuration = ParseNumber(ptr, NULL);
+        pConfig->Configuration = ParseNumber(field.Ptr, NULL);
         break;
 
       case 1:
-        pConfig->WPSPin = ParseNumber(ptr, NULL);
+        pConfig->WPSPin = ParseNumber(field.Ptr, NULL);
         break;
 
       case 2:
-        pConfig->VID = ParseNumber(ptr, NULL);
+        pConfig->VID = ParseNumber(field.Ptr, NULL);
         break;
 
       case 3:
-        pConfig->PID = ParseNumber(ptr, NULL);
+        pConfig->PID = ParseNumber(field.Ptr, NULL);
         break;
 
       case 4:
-        ParseMAC(ptr, pConfig->MAC);
+        ParseMAC(field.Ptr, pConfig->MAC);
         break;
 
       case 5:
-        ParseIP(ptr, pConfig->AP_IPAddress);
+        ParseIP(field.Ptr, pConfig->AP_IPAddress);
         break;
 
       case 6:
-        pConfig->PS_Mode = ParseNumber(ptr, NULL);
+        pConfig->PS_Mode = ParseNumber(field.Ptr, NULL);
         break;
 
       case 7:
-        pConfig->RadioMode = ParseNumber(ptr, NULL);
+        pConfig->RadioMode = ParseNumber(field.Ptr, NULL);
         break;
 
       case 8:
-        pConfig->CurrentBeacon = ParseNumber(ptr, NULL);
+        pConfig->CurrentBeacon = ParseNumber(field.Ptr, NULL);
         break;
 
       case 9:
-        pConfig->PrevBeacon = ParseNumber(ptr, NULL);
+        pConfig->PrevBeacon = ParseNumber(field.Ptr, NULL);
         break;
 
       case 10:
-        pConfig->ProductName = ParseNumber(ptr, NULL);
+        pConfig->ProductName = ParseNumber(field.Ptr, NULL);
         break;
 
       default:
         break;
     }
-    ptr = strtok(NULL, ",");
   }
 }
 
@@ -490,73 +680,69 @@ void IsmDrvClass::AT_ParseSystemConfig(char *pdata, ES_WIFI_SystemConfig_t *pCon
   */
 void IsmDrvClass::AT_ParseConnSettings(char *pdata, ES_WIFI_Network_t *NetSettings)
 {
+  AT_Fields_t fields;
+  AT_Span_t field;
   uint8_t num = 0;
-  char *ptr;
 
   if ((pdata == NULL) || (NetSettings == NULL)) {
     return;
   }
 
-  ptr = strtok(pdata + 2, ",");
+  AT_FieldsInit(&fields, pdata + 2, strlen(pdata + 2));
 
-  while (ptr != NULL) {
+  while (AT_NextField(&fields, ',', &field)) {
     switch (num++) {
       case 0:
-        strncpy((char *)NetSettings->SSID,  ptr, ES_WIFI_MAX_SSID_NAME_SIZE + 1);
+        AT_CopyField(NetSettings->SSID, ES_WIFI_MAX_SSID_NAME_SIZE + 1, &field);
         break;
 
       case 1:
-        strncpy((char *)NetSettings->pswd,  ptr, ES_WIFI_MAX_PSWD_NAME_SIZE + 1);
+        AT_CopyField(NetSettings->pswd, ES_WIFI_MAX_PSWD_NAME_SIZE + 1, &field);
         break;
 
       case 2:
-        NetSettings->Security = (ES_WIFI_SecurityType_t)ParseNumber(ptr, NULL);
+        NetSettings->Security = (ES_WIFI_SecurityType_t)ParseNumber(field.Ptr, NULL);
         break;
 
       case 3:
-        NetSettings->DHCP_IsEnabled = ParseNumber(ptr, NULL);
+        NetSettings->DHCP_IsEnabled = ParseNumber(field.Ptr, NULL);
         break;
 
       case 4:
-        NetSettings->IP_Ver = (ES_WIFI_IPVer_t)ParseNumber(ptr, NULL);
+        NetSettings->IP_Ver = (ES_WIFI_IPVer_t)ParseNumber(field.Ptr, NULL);
         break;
 
       case 5:
-        ParseIP(ptr, NetSettings->IP_Addr);
+        ParseIP(field.Ptr, NetSettings->IP_Addr);
         break;
 
       case 6:
-        ParseIP(ptr, NetSettings->IP_Mask);
+        ParseIP(field.Ptr, NetSettings->IP_Mask);
         break;
 
       case 7:
-        ParseIP(ptr, NetSettings->Gateway_Addr);
+        ParseIP(field.Ptr, NetSettings->Gateway_Addr);
         break;
 
       case 8:
-        ParseIP(ptr, NetSettings->DNS1);
+        ParseIP(field.Ptr, NetSettings->DNS1);
         break;
 
       case 9:
-        ParseIP(ptr, NetSettings->DNS2);
+        ParseIP(field.Ptr, NetSettings->DNS2);
         break;
 
       case 10:
-        NetSettings->JoinRetries = ParseNumber(ptr, NULL);
+        NetSettings->JoinRetries = ParseNumber(field.Ptr, NULL);
         break;
 
       case 11:
-        NetSettings->AutoConnect = ParseNumber(ptr, NULL);
+        NetSettings->AutoConnect = ParseNumber(field.Ptr, NULL);
         break;
 
       default:
         break;
     }
-    ptr = strtok(NULL, ",");
-    if ((ptr != NULL) && (ptr[-1] == ',')) {
-      /* Ignore empty fields */
-      num++;
-    }
   }
 }
 
@@ -568,69 +754,436 @@ void IsmDrvClass::AT_ParseConnSettings(char *pdata, ES_WIFI_Network_t *NetSettin
   */
 void IsmDrvClass::AT_ParseTrSettings(char *pdata, ES_WIFI_Conn_t *ConnSettings)
 {
+  AT_Fields_t fields;
+  AT_Span_t field;
   uint8_t num = 0;
-  char *ptr;
 
   if ((pdata == NULL) || (ConnSettings == NULL)) {
     return;
   }
 
-  ptr = strtok(pdata + 2, ",");
+  AT_FieldsInit(&fields, pdata + 2, strlen(pdata + 2));
 
-  while (ptr != NULL) {
+  while (AT_NextField(&fields, ',', &field)) {
     switch (num++) {
       case 0:
         // Protocol identifier
-        ptr++;
         break;
 
       case 1:
-        ParseIP(ptr, ConnSettings->RemoteIP);
+        ParseIP(field.Ptr, ConnSettings->RemoteIP);
         break;
 
       case 2:
-        ConnSettings->LocalPort = ParseNumber(ptr, NULL);
+        ConnSettings->LocalPort = ParseNumber(field.Ptr, NULL);
         break;
 
       case 3:
         // host IP;
-        ptr++;
         break;
 
       case 4:
-        ConnSettings->RemotePort = ParseNumber(ptr, NULL);
+        ConnSettings->RemotePort = ParseNumber(field.Ptr, NULL);
         break;
 
       default:
         break;
     }
-    ptr = strtok(NULL, ",");
-    if ((ptr != NULL) && (ptr[-1] == ',')) {
-      /* Ignore empty fields */
-      num++;
-    }
   }
 }
 
 /**
   * @brief  Execute AT command.
+  *         When the adaptive timeout of the class expires, the command fails
+  *         at once; its answer may still come until the configured timeout,
+  *         it is drained before the next command.
+  * @param  cmdClass: class of the command, which gives its timeout
   * @retval Operation Status.
   * @note  Command is in EsWifiObj.CmdData then it is used to store returned data
   */
-ES_WIFI_Status_t IsmDrvClass::AT_ExecuteCommand(void)
+ES_WIFI_Status_t IsmDrvClass::AT_ExecuteCommand(ES_WIFI_CmdClass_t cmdClass)
 {
-  int ret = 0;
+  ES_WIFI_Status_t ret = ES_WIFI_STATUS_IO_ERROR;
+  /* The answer overwrites the command */
+  const char code[2] = {(char)Cmd.Data()[0], (char)Cmd.Data()[1]};
+  uint32_t start;
 
-  PRINTCMD(EsWifiObj.CmdData);
-  ret = Drv->IO_Send(EsWifiObj.CmdData, strlen((char *)EsWifiObj.CmdData), EsWifiObj.Timeout);
-  if (ret > 0) {
-    return AT_ReceiveCommand(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE);
+  if (Cmd.Overflow()) {
+    return ES_WIFI_STATUS_ERROR;
   }
-  return ES_WIFI_STATUS_IO_ERROR;
+  AT_DrainLateAnswer();
+  PRINTDATA(Cmd.Data(), Cmd.Length());
+  EsWifiObj.Timeout = Timeouts[cmdClass].Current;
+  Framer.Reset();
+  start = micros();
+  if (Drv->IO_Send(Cmd.Data(), Cmd.Length(), EsWifiObj.Timeout) > 0) {
+    ret = AT_ReceiveCommand(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE);
+    if ((ret == ES_WIFI_STATUS_IO_ERROR) && (EsWifiObj.Timeout < Timeouts[cmdClass].Max)) {
+      /* The answer may only be late */
+      lateAnswer = true;
+      lateEnd = millis() + (Timeouts[cmdClass].Max - EsWifiObj.Timeout);
+    }
+  }
+  AT_UpdateTimeout(cmdClass, ret, micros() - start);
+  AT_Record(code, 0, ret, start);
+  AT_CheckLink(ret);
+  if (ret != ES_WIFI_STATUS_OK) {
+    /* The settings of the module are not certain anymore */
+    AT_InvalidateParams();
+  }
+  return ret;
+}
+
+/**
+  * @brief  Set the default timeout of each class of commands.
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::AT_InitTimeouts(void)
+{
+  Timeouts[ES_WIFI_CMD_CONFIG].Max = ES_WIFI_CONFIG_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_CONFIG].Adaptive = (ES_WIFI_ADAPTIVE_TIMEOUT != 0);
+  Timeouts[ES_WIFI_CMD_DATA].Max = ES_WIFI_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_DATA].Adaptive = false;
+  Timeouts[ES_WIFI_CMD_JOIN].Max = ES_WIFI_JOIN_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_JOIN].Adaptive = false;
+  Timeouts[ES_WIFI_CMD_SCAN].Max = ES_WIFI_SCAN_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_SCAN].Adaptive = false;
+  Timeouts[ES_WIFI_CMD_DNS].Max = ES_WIFI_DNS_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_DNS].Adaptive = false;
+  Timeouts[ES_WIFI_CMD_SLOW].Max = ES_WIFI_SLOW_TIMEOUT;
+  Timeouts[ES_WIFI_CMD_SLOW].Adaptive = false;
+  AT_ResetTimeouts();
+}
+
+/**
+  * @brief  Forget the observed latencies, the configured timeouts are used
+  *         until new ones are measured.
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::AT_ResetTimeouts(void)
+{
+  for (int i = 0; i < ES_WIFI_CMD_CLASSES; i++) {
+    Timeouts[i].Current = Timeouts[i].Max;
+    Timeouts[i].Srtt = 0;
+    Timeouts[i].RttVar = 0;
+  }
+  lateAnswer = false;
+}
+
+/**
+  * @brief  Drop the answer of the last command if its adaptive timeout
+  *         expired: it is waited for until the configured timeout of its
+  *         class, else it would be taken for the answer of the next command.
+  *         It is received after the next command, already in
+  *         EsWifiObj.CmdData, in as many parts as needed.
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::AT_DrainLateAnswer(void)
+{
+  /* Even, as the SPI reads 16-bit words */
+  uint16_t offset = (Cmd.Length() + 1) & ~1;
+  uint16_t size = ES_WIFI_DATA_SIZE - offset;
+  int32_t wait;
+  int16_t len;
+
+  if (!lateAnswer) {
+    return;
+  }
+  lateAnswer = false;
+  wait = (int32_t)(lateEnd - millis());
+  do {
+    len = Drv->IO_Receive(EsWifiObj.CmdData + offset, size, (wait > 0) ? wait : 1);
+    wait = 1;
+  } while (len == (int16_t)size);
+}
+
+/**
+  * @brief  Adapt the timeout of a class of commands to the latency of the
+  *         last command: smoothed latency plus 4 times its variation, within
+  *         ES_WIFI_MIN_TIMEOUT and the configured timeout. After a timeout
+  *         it is doubled, up to the configured timeout.
+  * @param  cmdClass: class of the command
+  * @param  status: status of the command
+  * @param  elapsed: duration of the command in us
+  * @retval None
+  */
+void IsmDrvClass::AT_UpdateTimeout(ES_WIFI_CmdClass_t cmdClass, ES_WIFI_Status_t status,
+                                   uint32_t elapsed)
+{
+  ES_WIFI_Timeout_t *t = &Timeouts[cmdClass];
+  uint32_t err;
+  uint32_t timeout;
+
+  if (!t->Adaptive) {
+    return;
+  }
+
+  if (status == ES_WIFI_STATUS_OK) {
+    if (t->Srtt == 0) {
+      t->Srtt = elapsed;
+      t->RttVar = elapsed / 2;
+    } else {
+      err = (elapsed > t->Srtt) ? (elapsed - t->Srtt) : (t->Srtt - elapsed);
+      t->RttVar = (3 * t->RttVar + err) / 4;
+      t->Srtt = (7 * t->Srtt + elapsed) / 8;
+    }
+    timeout = (t->Srtt + 4 * t->RttVar) / 1000 + 1;
+    if (timeout < ES_WIFI_MIN_TIMEOUT) {
+      timeout = ES_WIFI_MIN_TIMEOUT;
+    }
+    t->Current = (timeout < t->Max) ? timeout : t->Max;
+  } else if (status == ES_WIFI_STATUS_IO_ERROR) {
+    /* No answer in time: back off */
+    t->Current = (t->Current < t->Max / 2) ? (2 * t->Current) : t->Max;
+  }
+}
+
+/**
+  * @brief  Record an AT transaction in the journal and in the latency
+  *         histogram of its command.
+  * @param  code: the 2 characters of the command code
+  * @param  len: payload length
+  * @param  status: status of the transaction
+  * @param  start: micros() when the command was sent
+  * @retval None
+  */
+void IsmDrvClass::AT_Record(const char *code, uint16_t len, ES_WIFI_Status_t status,
+                            uint32_t start)
+{
+  uint32_t end = micros();
+
+#if ES_WIFI_JOURNAL_SIZE
+  ES_WIFI_JournalEntry_t *entry = &Journal[journalCount++ & (ES_WIFI_JOURNAL_SIZE - 1)];
+
+  entry->Cmd[0] = code[0];
+  entry->Cmd[1] = code[1];
+  entry->Socket = currentSock;
+  entry->Status = status;
+  entry->Len = len;
+  entry->Start = start;
+  entry->End = end;
+#else
+  UNUSED(len);
+  UNUSED(status);
+#endif
+#if ES_WIFI_LATENCY_STATS
+  AT_AddLatency(code, end - start);
+#elif (ES_WIFI_JOURNAL_SIZE == 0)
+  UNUSED(code);
+  UNUSED(start);
+  UNUSED(end);
+#endif
+}
+
+/**
+  * @brief  Count a latency in the histogram of its command. The first
+  *         ES_WIFI_LATENCY_CMDS commands seen get a histogram.
+  * @param  code: the 2 characters of the command code
+  * @param  elapsed: latency in us
+  * @retval None
+  */
+void IsmDrvClass::AT_AddLatency(const char *code, uint32_t elapsed)
+{
+#if ES_WIFI_LATENCY_STATS
+  ES_WIFI_Latency_t *hist = NULL;
+  uint8_t bucket;
+
+  for (int i = 0; i < ES_WIFI_LATENCY_CMDS; i++) {
+    if (Latency[i].Cmd[0] == 0) {
+      Latency[i].Cmd[0] = code[0];
+      Latency[i].Cmd[1] = code[1];
+    }
+    if ((Latency[i].Cmd[0] == code[0]) && (Latency[i].Cmd[1] == code[1])) {
+      hist = &Latency[i];
+      break;
+    }
+  }
+  if (hist == NULL) {
+    return;
+  }
+
+  /* Bucket of the most significant bit */
+  bucket = (elapsed == 0) ? 0 : (31 - __builtin_clz(elapsed));
+  if (bucket >= ES_WIFI_LATENCY_BUCKETS) {
+    bucket = ES_WIFI_LATENCY_BUCKETS - 1;
+  }
+  hist->Count[bucket]++;
+#else
+  UNUSED(code);
+  UNUSED(elapsed);
+#endif
+}
+
+/**
+  * @brief  Count the exchanges in a row without answer from the module and
+  *         request its recovery after ES_WIFI_RECOVERY_THRESHOLD of them. It
+  *         is run by AT_Recover at the start of the next operation, never in
+  *         the middle of an exchange.
+  * @param  status: status of the exchange
+  * @retval None
+  */
+void IsmDrvClass::AT_CheckLink(ES_WIFI_Status_t status)
+{
+#if ES_WIFI_RECOVERY
+  if (status != ES_WIFI_STATUS_IO_ERROR) {
+    Recovery.Failures = 0;
+    return;
+  }
+  Recovery.Stats.IOFailures++;
+  if (Recovery.Failures < ES_WIFI_RECOVERY_THRESHOLD) {
+    Recovery.Failures++;
+  }
+  if (Recovery.Failures >= ES_WIFI_RECOVERY_THRESHOLD) {
+    Recovery.Pending = true;
+  }
+#else
+  UNUSED(status);
+#endif
+}
+
+/**
+  * @brief  Recover a module which stopped answering. The link is first
+  *         resynchronized; if the module still does not answer, it is reset.
+  *         Then the network is joined again if it was lost. If the module was
+  *         reset or lost the network, the connections of the client sockets
+  *         are lost: the sockets are freed, so that their owners see them
+  *         closed. The servers are not restarted. After a failure, the next attempt
+  *         is delayed, twice as long each time.
+  * @param  None
+  * @retval None
+  * @note  Called at the start of the operations which exchange with the
+  *        module, it does nothing unless AT_CheckLink requested a recovery.
+  */
+void IsmDrvClass::AT_Recover(void)
+{
+#if ES_WIFI_RECOVERY
+  ES_WIFI_Status_t ret = ES_WIFI_STATUS_IO_ERROR;
+  uint8_t sock = currentSock;
+  bool linkUp = false;
+  bool lost = false;
+
+  if (!Recovery.Pending || !Recovery.Enabled || Recovery.Running ||
+      ((millis() - Recovery.Last) < Recovery.Backoff)) {
+    return;
+  }
+  Recovery.Running = true;
+  Recovery.Stats.Recoveries++;
+
+  /* The module may only have lost an answer: resynchronize the link */
+  if (Drv->IO_Init(IO_INIT_WARM) == 0) {
+    Cmd.Start(AT_NET_GET_CONNECTION_STATUS).End();
+    ret = AT_ExecuteCommand();
+  }
+  if (ret == ES_WIFI_STATUS_OK) {
+    Recovery.Stats.Resyncs++;
+    linkUp = (ParseNumber((char *)EsWifiObj.CmdData + 2, NULL) == 1);
+  } else {
+    Recovery.Stats.Resets++;
+    AT_ResetTimeouts();
+    if (Drv->IO_Init(IO_INIT_COLD) == 0) {
+      Cmd.Start(AT_API_SHOW_SETTINGS).End();
+      ret = AT_ExecuteCommand();
+    }
+    lost = true;
+  }
+
+  if ((ret == ES_WIFI_STATUS_OK) && !linkUp && (Recovery.SSID[0] != '\0')) {
+    Recovery.Stats.Rejoins++;
+    ret = ES_WIFI_Connect(Recovery.SSID, Recovery.Pswd, Recovery.Security);
+    lost = true;
+  }
+
+  /* Connections lost: reopened, the sockets would be new connections */
+  if (lost) {
+    for (uint8_t i = 0; i < MAX_SOCK_NUM; i++) {
+      if (Recovery.ClientSockets & (1 << i)) {
+        sockState[i] = SOCKET_FREE;
+        Recovery.Stats.Drops++;
+      }
+    }
+    Recovery.ClientSockets = 0;
+  }
+
+  if (ret == ES_WIFI_STATUS_OK) {
+    Recovery.Backoff = 0;
+  } else {
+    Recovery.Stats.Failures++;
+    Recovery.Last = millis();
+    if (Recovery.Backoff == 0) {
+      Recovery.Backoff = ES_WIFI_RECOVERY_BACKOFF_MIN;
+    } else {
+      Recovery.Backoff = (Recovery.Backoff < ES_WIFI_RECOVERY_BACKOFF_MAX / 2) ?
+                         (2 * Recovery.Backoff) : ES_WIFI_RECOVERY_BACKOFF_MAX;
+    }
+  }
+  Recovery.Failures = 0;
+  Recovery.Pending = false;
+  currentSock = sock;
+  Recovery.Running = false;
+#endif
+}
+
+/**
+  * @brief  Forget the copy of the socket settings of the module.
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::AT_InvalidateParams(void)
+{
+  Params.Socket = ES_WIFI_PARAM_UNKNOWN;
+  Params.WriteTimeout = ES_WIFI_PARAM_UNKNOWN;
+  Params.WritePacketSize = ES_WIFI_PARAM_UNKNOWN;
+  Params.ReadPacketSize = ES_WIFI_PARAM_UNKNOWN;
+  Params.ReadTimeout = ES_WIFI_PARAM_UNKNOWN;
+}
+
+/**
+  * @brief  Set a numerical setting of the module.
+  *         The command is skipped if the module already has this value.
+  * @param  cmd: command of the setting
+  * @param  value: value to set
+  * @param  param: copy of the setting in Params
+  * @retval Operation Status.
+  */
+ES_WIFI_Status_t IsmDrvClass::AT_SetParam(const char (&cmd)[3], uint32_t value, uint32_t *param)
+{
+  ES_WIFI_Status_t ret;
+
+#if ES_WIFI_SHADOW_PARAMS
+  if (*param == value) {
+    return ES_WIFI_STATUS_OK;
+  }
+#endif
+  Cmd.Start(cmd).Char('=').Uint(value).End();
+  ret = AT_ExecuteCommand();
+  if (ret == ES_WIFI_STATUS_OK) {
+    *param = value;
+  }
+  return ret;
+}
+
+/**
+  * @brief  Select the socket the next commands apply to (P0).
+  *         The read and write settings are kept only while the same socket
+  *         is used.
+  * @param  socket: socket number
+  * @retval Operation Status.
+  */
+ES_WIFI_Status_t IsmDrvClass::AT_SelectSocket(uint8_t socket)
+{
+  if (Params.Socket != socket) {
+    AT_InvalidateParams();
+  }
+  return AT_SetParam(AT_TR_SET_SOCKET, socket, &Params.Socket);
 }
 
 /**
   * @brief  Receive command response
+  *         The answer may be received in several parts, each part is fed
+  *         to the framer which keeps the state from the previous ones.
   * @param  pdata: pointer to returned data
   * @retval Operation Status.
   */
@@ -638,22 +1191,25 @@ ES_WIFI_Status_t IsmDrvClass::AT_ReceiveCommand(uint8_t *pdata, uint16_t len)
 {
   int16_t recv_len = 0;
   /* Read len - AT_OK_STRING_LEN -2 to be able to
-     append '\0' and also ensure to get the full AT_OK_STRING_LEN in case of a full buffer */
-  recv_len = Drv->IO_Receive(pdata, len - AT_OK_STRING_LEN - 2, EsWifiObj.Timeout);
+     append '\0' and also ensure to get the full AT_OK_STRING_LEN in case of a full buffer.
+     Even, as the SPI reads 16-bit words: a full buffer then has this length */
+  uint16_t size = (len - AT_OK_STRING_LEN - 2) & ~1;
+
+  recv_len = Drv->IO_Receive(pdata, size, EsWifiObj.Timeout);
   if ((recv_len > 0) && (recv_len < len)) {
     *(pdata + recv_len) = 0;
     PRINTCMD(pdata);
-    if (strstr((char *)pdata, AT_OK_STRING)) {
-      return ES_WIFI_STATUS_OK;
-    } else {
-      if (strstr((char *)pdata, AT_ERROR_STRING)) {
+    switch (Framer.Feed(pdata, recv_len)) {
+      case AT_FRAME_OK:
+        return ES_WIFI_STATUS_OK;
+      case AT_FRAME_ERROR:
         return ES_WIFI_STATUS_ERROR;
-      } else {
+      default:
         /* Some data still to get. Typically with AP list */
-        if (recv_len == (int16_t)(len - AT_OK_STRING_LEN - 2)) {
+        if (recv_len == (int16_t)size) {
           return ES_WIFI_STATUS_REQ_DATA_STAGE;
         }
-      }
+        break;
     }
   }
   return ES_WIFI_STATUS_IO_ERROR;
@@ -661,87 +1217,131 @@ ES_WIFI_Status_t IsmDrvClass::AT_ReceiveCommand(uint8_t *pdata, uint16_t len)
 
 /**
   * @brief  Execute AT command with data.
+  *         The command and the data are sent back to back without copy, the
+  *         answer is stored in EsWifiObj.CmdData.
   * @param  cmd: pointer to command string
-  * @param  pcmd_data: pointer to binary data
+  * @param  cmdlen: command string length
+  * @param  pdata: pointer to binary data
   * @param  len: binary data length
-  * @param  pdata: pointer to returned data
   * @retval Operation Status.
   */
-ES_WIFI_Status_t IsmDrvClass::AT_RequestSendData(uint8_t *cmd,
-                                                 uint16_t len, uint8_t *pdata)
+ES_WIFI_Status_t IsmDrvClass::AT_RequestSendData(uint8_t *cmd, uint16_t cmdlen,
+                                                 uint8_t *pdata, uint16_t len)
 {
+  IO_Segment_t seg[2] = {{cmd, cmdlen}, {pdata, len}};
+  uint8_t *p = EsWifiObj.CmdData;
+  ES_WIFI_Status_t ret = ES_WIFI_STATUS_IO_ERROR;
+  uint32_t start;
+
   if ((cmd == NULL) || (pdata == NULL)) {
     return ES_WIFI_STATUS_ERROR;
   }
-  PRINTCMD(cmd);
-  if (Drv->IO_Send(cmd, len, EsWifiObj.Timeout) > 0) {
-    PRINTDATA(cmd, len);
+  /* The answer may overwrite the command */
+  const char code[2] = {(char)cmd[0], (char)cmd[1]};
+  AT_DrainLateAnswer();
+  PRINTDATA(cmd, cmdlen);
+  EsWifiObj.Timeout = Timeouts[ES_WIFI_CMD_DATA].Current;
+  start = micros();
+  if (Drv->IO_SendSegments(seg, 2, EsWifiObj.Timeout) > 0) {
+    PRINTDATA(pdata, len);
 
-    int16_t n = Drv->IO_Receive(pdata, ES_WIFI_DATA_SIZE, EsWifiObj.Timeout);
+    int16_t n = Drv->IO_Receive(p, ES_WIFI_DATA_SIZE, EsWifiObj.Timeout);
     if ((n > 0) && (n < ES_WIFI_DATA_SIZE)) {
-      PRINTCMD(pdata);
-      *(pdata + n) = 0;
-      if (strstr((char *)pdata, AT_OK_STRING)) {
-        return ES_WIFI_STATUS_OK;
-      } else if (strstr((char *)pdata, AT_ERROR_STRING)) {
-        return ES_WIFI_STATUS_ERROR;
-      } else {
+      PRINTCMD(p);
+      *(p + n) = 0;
+      Framer.Reset();
+      switch (Framer.Feed(p, n)) {
+        case AT_FRAME_OK:
+          ret = ES_WIFI_STATUS_OK;
+          break;
+        case AT_FRAME_ERROR:
+          ret = ES_WIFI_STATUS_ERROR;
+          break;
+        default:
+          break;
       }
-    } else {
     }
   }
-  return ES_WIFI_STATUS_IO_ERROR;
+  AT_Record(code, len, ret, start);
+  AT_CheckLink(ret);
+  return ret;
+}
+
+/**
+  * @brief  Compare received bytes split between a payload buffer and the
+  *         trailer buffer that follows it.
+  * @param  pdata: payload buffer
+  * @param  Reqlen: payload buffer length
+  * @param  tail: trailer buffer
+  * @param  offset: offset of the first byte to compare
+  * @param  str: expected bytes
+  * @param  len: number of bytes to compare
+  * @retval true if the bytes match.
+  */
+static bool MatchReceivedData(const char *pdata, uint16_t Reqlen, const uint8_t *tail,
+                              uint16_t offset, const char *str, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++, offset++) {
+    char c = (offset < Reqlen) ? pdata[offset] : (char)tail[offset - Reqlen];
+    if (c != str[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
 /**
   * @brief  Parses Received data.
-  * @param  cmd:command formatted string
+  *         The payload is received straight into pdata, only the answer
+  *         header and the trailer of a full payload are kept aside.
+  * @param  cmd: command formatted string
+  * @param  cmdlen: command string length
   * @param  pdata: payload
   * @param  Reqlen : requested Data length.
   * @param  ReadData : pointer to received data length.
   * @retval Operation Status.
   */
-ES_WIFI_Status_t IsmDrvClass::AT_RequestReceiveData(uint8_t *cmd,  char *pdata,
+ES_WIFI_Status_t IsmDrvClass::AT_RequestReceiveData(uint8_t *cmd, uint16_t cmdlen, char *pdata,
                                                     uint16_t Reqlen, uint16_t *ReadData)
 {
-  uint16_t len;
-  uint8_t *p = EsWifiObj.CmdData;
-  char *match = NULL;
+  int16_t len;
+  uint8_t head[2];                           // "\r\n" before the payload
+  uint8_t tail[AT_OK_STRING_LEN + 3];        // answer end after a full payload
+  IO_Segment_t seg[3] = {{head, sizeof(head)}, {(uint8_t *)pdata, Reqlen}, {tail, sizeof(tail)}};
+  ES_WIFI_Status_t ret = ES_WIFI_STATUS_IO_ERROR;
+  uint32_t start;
 
   if ((cmd == NULL) || (pdata == NULL) || (ReadData == NULL)) {
     return ES_WIFI_STATUS_ERROR;
   }
 
-  PRINTCMD(cmd);
+  AT_DrainLateAnswer();
+  PRINTDATA(cmd, cmdlen);
+  EsWifiObj.Timeout = Timeouts[ES_WIFI_CMD_DATA].Current;
+  start = micros();
 
-  if (Drv->IO_Send(cmd, strlen((char *)cmd), EsWifiObj.Timeout) > 0) {
-    len = Drv->IO_Receive(p, ES_WIFI_DATA_SIZE, EsWifiObj.Timeout);
-    if ((len >= 2) && ((p[0] == '\r') || (p[1] == '\n'))) {
-      PRINTDATA(p, 2);
+  if (Drv->IO_Send(cmd, cmdlen, EsWifiObj.Timeout) > 0) {
+    len = Drv->IO_ReceiveSegments(seg, 3, EsWifiObj.Timeout);
+    if ((len >= 2) && ((head[0] == '\r') || (head[1] == '\n'))) {
+      PRINTDATA(head, 2);
       len -= 2;
-      p += 2;
-      while (len && (p[len - 1] == 0x15)) {
-        len--;
-      }
-      if (len >= AT_OK_STRING_LEN) {
-        p[len] = '\0';
-        if (strstr((char *) p + len - AT_OK_STRING_LEN, AT_OK_STRING)) {
+      if (len >= (int16_t)AT_OK_STRING_LEN) {
+        if (MatchReceivedData(pdata, Reqlen, tail, len - AT_OK_STRING_LEN,
+                              AT_OK_STRING, AT_OK_STRING_LEN)) {
           *ReadData = len - AT_OK_STRING_LEN;
           if (*ReadData > Reqlen) {
             *ReadData = Reqlen;
           }
-          memcpy(pdata, p, *ReadData);
-          return ES_WIFI_STATUS_OK;
-        } else {
-          match = strstr((char *)p, "-1\r\n");
-          if (match && (match == (char *)p)) {
-            return ES_WIFI_STATUS_ERROR;
-          }
+          ret = ES_WIFI_STATUS_OK;
+        } else if (MatchReceivedData(pdata, Reqlen, tail, 0, "-1\r\n", 4)) {
+          ret = ES_WIFI_STATUS_ERROR;
         }
       }
     }
   }
-  return ES_WIFI_STATUS_IO_ERROR;
+  AT_Record((const char *)cmd, (ret == ES_WIFI_STATUS_OK) ? *ReadData : 0, ret, start);
+  AT_CheckLink(ret);
+  return ret;
 }
 
 
@@ -750,23 +1350,43 @@ ES_WIFI_Status_t IsmDrvClass::AT_RequestReceiveData(uint8_t *cmd,  char *pdata,
 
 /**
   * @brief  Initialize WiFi module.
+  *         With warm start, a module already running is used as is when it
+  *         answers, otherwise it is reset.
   * @param  None.
   * @retval Operation Status.
   */
 ES_WIFI_Status_t IsmDrvClass::ES_WIFI_Init()
 {
   ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
+  IO_InitMode_t mode = warmStart ? IO_INIT_WARM : IO_INIT_COLD;
+  uint32_t start = millis();
+
+  AT_InvalidateParams();
+  AT_ResetTimeouts();
+#if ES_WIFI_RECOVERY
+  Recovery.Failures = 0;
+  Recovery.Pending = false;
+  Recovery.ClientSockets = 0;
+  Recovery.SSID[0] = '\0';
+#endif
 
-  EsWifiObj.Timeout = ES_WIFI_TIMEOUT;
-
-  if (Drv->IO_Init() == 0) {
-    strcpy((char *)EsWifiObj.CmdData, AT_API_SHOW_SETTINGS);
-    strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+  /* A module already running is used if it answers, else it is reset       */
+  for (;;) {
+    if (Drv->IO_Init(mode) == 0) {
+      Cmd.Start(AT_API_SHOW_SETTINGS).End();
+      ret = AT_ExecuteCommand();
 
-    if (ret == ES_WIFI_STATUS_OK) {
-      AT_ParseInfo(EsWifiObj.CmdData);
+      if (ret == ES_WIFI_STATUS_OK) {
+        AT_ParseInfo(EsWifiObj.CmdData);
+        writeWithLength = (AT_ParseFWRev((char *)EsWifiObj.FW_Rev) >= ES_WIFI_S3_MIN_FW_REV);
+        bootTime = millis() - start;
+        break;
+      }
+    }
+    if (mode == IO_INIT_COLD) {
+      break;
     }
+    mode = IO_INIT_COLD;
   }
   return ret;
 }
@@ -833,13 +1453,14 @@ uint8_t   *IsmDrvClass::ES_WIFI_GetRTOSRev()
 
 
 /**
-  * @brief  Change default Timeout.
+  * @brief  Change the timeout of the socket data exchanges.
   * @param  Timeout: Timeout in ms.
   * @retval Operation Status.
   */
 ES_WIFI_Status_t  IsmDrvClass::ES_WIFI_SetTimeout(uint32_t Timeout)
 {
-  EsWifiObj.Timeout = Timeout;
+  Timeouts[ES_WIFI_CMD_DATA].Max = Timeout;
+  Timeouts[ES_WIFI_CMD_DATA].Current = Timeout;
   return ES_WIFI_STATUS_OK;
 }
 
@@ -851,37 +1472,35 @@ ES_WIFI_Status_t  IsmDrvClass::ES_WIFI_SetTimeout(uint32_t Timeout)
 void IsmDrvClass::ES_WIFI_ListAccessPoints()
 {
   ES_WIFI_Status_t ret;
-  char *curr_ptr = NULL;
-  char *sav_ptr = NULL;
-  char pdata[128] = {'\0'};
+  AT_Fields_t lines;
+  AT_Span_t line;
+
+  AT_Recover();
   /* Reset AP number */
   ESWifiApObj.nbr = 0;
 
-  strcpy((char *)EsWifiObj.CmdData, AT_SCAN);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-  ret = AT_ExecuteCommand();
+  Cmd.Start(AT_SCAN).End();
+  ret = AT_ExecuteCommand(ES_WIFI_CMD_SCAN);
   if ((ret == ES_WIFI_STATUS_OK) || (ret == ES_WIFI_STATUS_REQ_DATA_STAGE)) {
-    /* Init AP tokenization */
-    curr_ptr = strtok_r((char *)(EsWifiObj.CmdData), "\n", &sav_ptr);
-    while ((curr_ptr != NULL) && (ESWifiApObj.nbr < ES_WIFI_MAX_DETECTED_AP)) {
-      if ((*curr_ptr) != '#') {
-        curr_ptr = strtok_r(NULL, "\n", &sav_ptr);
-      } else {
-        /* save AP info */
-        strcpy(pdata, curr_ptr);
-        if (AT_ParseSingleAP(pdata, &(ESWifiApObj.AP[ESWifiApObj.nbr]))) {
-          ESWifiApObj.nbr++;
-          curr_ptr = strtok_r(NULL, "\n", &sav_ptr);
-        } else {
-          if (ret == ES_WIFI_STATUS_REQ_DATA_STAGE) {
-            strcpy((char *)EsWifiObj.CmdData, curr_ptr);
-            ret = AT_ReceiveCommand(EsWifiObj.CmdData + strlen(curr_ptr), ES_WIFI_DATA_SIZE - strlen(curr_ptr));
-            if ((ret != ES_WIFI_STATUS_OK) && (ret != ES_WIFI_STATUS_REQ_DATA_STAGE)) {
-              break;
-            }
-            curr_ptr = strtok_r((char *)(EsWifiObj.CmdData), "\n", &sav_ptr);
-          }
+    /* Parse the APs in place, one line each */
+    AT_FieldsInit(&lines, (char *)EsWifiObj.CmdData, strlen((char *)EsWifiObj.CmdData));
+    while ((ESWifiApObj.nbr < ES_WIFI_MAX_DETECTED_AP) && AT_NextField(&lines, '\n', &line)) {
+      if ((line.Len == 0) || (line.Ptr[0] != '#')) {
+        continue;
+      }
+      if ((!lines.Delimited) && (ret == ES_WIFI_STATUS_REQ_DATA_STAGE) &&
+          (line.Len < ES_WIFI_DATA_SIZE / 2)) {
+        /* Line cut by the end of the buffer: keep it and receive the rest */
+        memmove(EsWifiObj.CmdData, line.Ptr, line.Len);
+        ret = AT_ReceiveCommand(EsWifiObj.CmdData + line.Len, ES_WIFI_DATA_SIZE - line.Len);
+        if ((ret != ES_WIFI_STATUS_OK) && (ret != ES_WIFI_STATUS_REQ_DATA_STAGE)) {
+          break;
         }
+        AT_FieldsInit(&lines, (char *)EsWifiObj.CmdData, strlen((char *)EsWifiObj.CmdData));
+        continue;
+      }
+      if (AT_ParseSingleAP(&line, &(ESWifiApObj.AP[ESWifiApObj.nbr]))) {
+        ESWifiApObj.nbr++;
       }
     }
     /* Flush last AP */
@@ -917,32 +1536,36 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_Connect(const char *SSID,
     return ES_WIFI_STATUS_ERROR;
   }
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=%s%s",
-          AT_NET_SET_SSID, SSID, SUFFIX_CMD);
+  Cmd.Start(AT_NET_SET_SSID).Char('=').Str(SSID).End();
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=%s%s",
-            AT_NET_SET_PASSPHRASE, Password, SUFFIX_CMD);
+    Cmd.Start(AT_NET_SET_PASSPHRASE).Char('=').Str(Password).End();
     ret = AT_ExecuteCommand();
 
     if (ret == ES_WIFI_STATUS_OK) {
       EsWifiObj.Security = SecType;
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_NET_SET_SECURITY_TYPE, SecType, SUFFIX_CMD);
+      Cmd.Start(AT_NET_SET_SECURITY_TYPE).Char('=').Int(SecType).End();
       ret = AT_ExecuteCommand();
 
 
       if (ret == ES_WIFI_STATUS_OK) {
         //Allows to wait the response in case of reconnection.
         // If less, then the response is missed and the reconnection is longer.
-        ES_WIFI_SetTimeout(10000);
-        strcpy((char *)EsWifiObj.CmdData, AT_NET_JOIN);
-        strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-        ret = AT_ExecuteCommand();
+        Cmd.Start(AT_NET_JOIN).End();
+        ret = AT_ExecuteCommand(ES_WIFI_CMD_JOIN);
         if (ret == ES_WIFI_STATUS_OK) {
           EsWifiObj.NetSettings.IsConnected = 1;
+#if ES_WIFI_RECOVERY
+          /* Kept to join the network again after a reset of the module */
+          if (!Recovery.Running) {
+            strncpy(Recovery.SSID, SSID, ES_WIFI_MAX_SSID_NAME_SIZE);
+            Recovery.SSID[ES_WIFI_MAX_SSID_NAME_SIZE] = '\0';
+            strncpy(Recovery.Pswd, Password, ES_WIFI_MAX_PSWD_NAME_SIZE);
+            Recovery.Pswd[ES_WIFI_MAX_PSWD_NAME_SIZE] = '\0';
+            Recovery.Security = SecType;
+          }
+#endif
         }
-        ES_WIFI_SetTimeout(ES_WIFI_TIMEOUT);
       }
     }
   }
@@ -956,8 +1579,10 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_Connect(const char *SSID,
   */
 void IsmDrvClass::ES_WIFI_Disconnect()
 {
-  strcpy((char *)EsWifiObj.CmdData, AT_NET_DISCONNECT);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
+#if ES_WIFI_RECOVERY
+  Recovery.SSID[0] = '\0';
+#endif
+  Cmd.Start(AT_NET_DISCONNECT).End();
   AT_ExecuteCommand();
 }
 
@@ -970,8 +1595,8 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_GetNetworkSettings()
 {
   ES_WIFI_Status_t ret;
 
-  strcpy((char *)EsWifiObj.CmdData, AT_NET_SHOW_SETTINGS);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
+  AT_Recover();
+  Cmd.Start(AT_NET_SHOW_SETTINGS).End();
   ret = AT_ExecuteCommand();
 
   if (ret == ES_WIFI_STATUS_OK) {
@@ -989,8 +1614,7 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_GetTrSettings(uint8_t index)
 {
   ES_WIFI_Status_t ret;
 
-  strcpy((char *)EsWifiObj.CmdData, AT_TR_SHOW_SETTNGS);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
+  Cmd.Start(AT_TR_SHOW_SETTNGS).End();
   ret = AT_ExecuteCommand();
 
   if (ret == ES_WIFI_STATUS_OK) {
@@ -1008,18 +1632,15 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_GetTrSettings(uint8_t index)
 uint8_t *IsmDrvClass::ES_WIFI_GetMACAddress(uint8_t *mac)
 {
   ES_WIFI_Status_t ret ;
-  char *ptr;
 
   if (mac == NULL) {
     return NULL;
   }
 
-  strcpy((char *)EsWifiObj.CmdData, AT_SYS_GET_MAC_ADDR);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
+  Cmd.Start(AT_SYS_GET_MAC_ADDR).End();
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
-    ptr = strtok((char *)(EsWifiObj.CmdData + 2), "\r\n");
-    ParseMAC(ptr, EsWifiObj.APSettings.MAC_Addr);
+    ParseMAC((char *)EsWifiObj.CmdData + 2, EsWifiObj.APSettings.MAC_Addr);
     for (int i = 0; i < 6; i++) {
       mac[i] = EsWifiObj.APSettings.MAC_Addr[i];
     }
@@ -1156,8 +1777,8 @@ int32_t IsmDrvClass::ES_WIFI_GetRSSI()
   ES_WIFI_Status_t ret;
   char *ptr;
 
-  strcpy((char *)EsWifiObj.CmdData, AT_NET_GET_RSSI);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
+  AT_Recover();
+  Cmd.Start(AT_NET_GET_RSSI).End();
   ret = AT_ExecuteCommand();
 
   if (ret == ES_WIFI_STATUS_OK) {
@@ -1199,15 +1820,19 @@ void IsmDrvClass::ES_WIFI_SetMACAddress(uint8_t *mac)
     return;
   }
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=%X:%X:%X:%X:%X:%X%s",
-          AT_SYS_SET_MAC_ADDR, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
-          SUFFIX_CMD);
+  Cmd.Start(AT_SYS_SET_MAC_ADDR).Char('=');
+  for (int i = 0; i < 6; i++) {
+    if (i != 0) {
+      Cmd.Char(':');
+    }
+    Cmd.Hex(mac[i]);
+  }
+  Cmd.End();
 
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
-    strcpy((char *)EsWifiObj.CmdData, AT_SYS_SAVE_SETTINGS);
-    strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+    Cmd.Start(AT_SYS_SAVE_SETTINGS).End();
+    ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
   }
 }
 
@@ -1218,9 +1843,9 @@ void IsmDrvClass::ES_WIFI_SetMACAddress(uint8_t *mac)
   */
 void IsmDrvClass::ES_WIFI_ResetToFactoryDefault()
 {
-  strcpy((char *)EsWifiObj.CmdData, AT_SYS_SET_RESET_FACTORY);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-  AT_ExecuteCommand();
+  Cmd.Start(AT_SYS_SET_RESET_FACTORY).End();
+  AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
+  AT_InvalidateParams();
 }
 
 /**
@@ -1230,9 +1855,9 @@ void IsmDrvClass::ES_WIFI_ResetToFactoryDefault()
   */
 void IsmDrvClass::ES_WIFI_ResetModule()
 {
-  strcpy((char *)EsWifiObj.CmdData, AT_SYS_RESET_MODULE);
-  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-  AT_ExecuteCommand();
+  Cmd.Start(AT_SYS_RESET_MODULE).End();
+  AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
+  AT_InvalidateParams();
 }
 
 /**
@@ -1248,14 +1873,12 @@ void IsmDrvClass::ES_WIFI_SetProductName(uint8_t *ProductName)
     return;
   }
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=%s%s",
-          AT_SYS_SET_PRODUCT_NAME, ProductName, SUFFIX_CMD);
+  Cmd.Start(AT_SYS_SET_PRODUCT_NAME).Char('=').Str((char *)ProductName).End();
 
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
-    strcpy((char *)EsWifiObj.CmdData, AT_SYS_SAVE_SETTINGS);
-    strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+    Cmd.Start(AT_SYS_SAVE_SETTINGS).End();
+    ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
   }
 }
 
@@ -1268,7 +1891,7 @@ ES_WIFI_Status_t IsmDrvClass::ES_WIFI_GetSystemConfig()
 {
   ES_WIFI_Status_t ret ;
 
-  sprintf((char *)EsWifiObj.CmdData, "%s%s", AT_SYS_SHOW_SETTINGS, SUFFIX_CMD);
+  Cmd.Start(AT_SYS_SHOW_SETTINGS).End();
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
     AT_ParseSystemConfig((char *)EsWifiObj.CmdData, &ESWifiSysObj);
@@ -1290,27 +1913,23 @@ void IsmDrvClass::ES_WIFI_Ping(uint8_t *address, uint16_t count, uint16_t interv
   if (address == NULL) {
     return;
   }
+  AT_Recover();
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=%d.%d.%d.%d%s",
-          AT_PING_SET_TARGET_ADDR, address[0], address[1],
-          address[2], address[3], SUFFIX_CMD);
+  Cmd.Start(AT_PING_SET_TARGET_ADDR).Char('=').Ip(address).End();
 
   ret = AT_ExecuteCommand();
 
   if (ret == ES_WIFI_STATUS_OK) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-            AT_PING_SET_REPEAT_COUNT, count, SUFFIX_CMD);
+    Cmd.Start(AT_PING_SET_REPEAT_COUNT).Char('=').Int(count).End();
     ret = AT_ExecuteCommand();
 
     if (ret == ES_WIFI_STATUS_OK) {
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_PING_SET_DELAY_MS, interval_ms, SUFFIX_CMD);
+      Cmd.Start(AT_PING_SET_DELAY_MS).Char('=').Int(interval_ms).End();
       ret = AT_ExecuteCommand();
 
       if (ret == ES_WIFI_STATUS_OK) {
-        strcpy((char *)EsWifiObj.CmdData, AT_PING_TARGET_ADDR);
-        strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-        ret = AT_ExecuteCommand();
+        Cmd.Start(AT_PING_TARGET_ADDR).End();
+        ret = AT_ExecuteCommand(ES_WIFI_CMD_DNS);
       }
     }
   }
@@ -1325,20 +1944,18 @@ void IsmDrvClass::ES_WIFI_Ping(uint8_t *address, uint16_t count, uint16_t interv
 void IsmDrvClass::ES_WIFI_DNS_LookUp(const char *url, IPAddress *ipaddress)
 {
   ES_WIFI_Status_t ret;
-  char *ptr;
   uint8_t temp[4];
 
   if ((url == NULL) || (ipaddress == NULL)) {
     return;
   }
+  AT_Recover();
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=%s%s",
-          AT_DNS_LOOKUP, url, SUFFIX_CMD);
-  ret = AT_ExecuteCommand();
+  Cmd.Start(AT_DNS_LOOKUP).Char('=').Str(url).End();
+  ret = AT_ExecuteCommand(ES_WIFI_CMD_DNS);
 
   if (ret == ES_WIFI_STATUS_OK) {
-    ptr = strtok((char *)EsWifiObj.CmdData + 2, "\r");
-    ParseIP(ptr, temp);
+    ParseIP((char *)EsWifiObj.CmdData + 2, temp);
     *ipaddress = IPAddress(temp);
   }
 }
@@ -1352,45 +1969,43 @@ void IsmDrvClass::ES_WIFI_DNS_LookUp(const char *url, IPAddress *ipaddress)
 bool IsmDrvClass::ES_WIFI_StartClientConnection(uint8_t index)
 {
   ES_WIFI_Status_t ret;
+
+  AT_Recover();
   currentSock = index;
   sockState[index] = SOCKET_BUSY;
-  sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-          AT_TR_SET_SOCKET, ESWifiConnTab[index].Number, SUFFIX_CMD);
-  ret = AT_ExecuteCommand();
+  AT_ClearBuffers(index);
+  ret = AT_SelectSocket(ESWifiConnTab[index].Number);
 
   if (ret == ES_WIFI_STATUS_OK) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-            AT_TR_SET_PROTOCOL, ESWifiConnTab[index].Type, SUFFIX_CMD);
+    Cmd.Start(AT_TR_SET_PROTOCOL).Char('=').Int(ESWifiConnTab[index].Type).End();
     ret = AT_ExecuteCommand();
     if (ret == ES_WIFI_STATUS_OK) {
       if ((ESWifiConnTab[index].Type == ES_WIFI_UDP_CONNECTION) && (ESWifiConnTab[index].LocalPort > 0)) {
-        sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-                AT_TR_SET_LOCAL_PORT_NUMBER, ESWifiConnTab[index].LocalPort,
-                SUFFIX_CMD);
+        Cmd.Start(AT_TR_SET_LOCAL_PORT_NUMBER).Char('=').Int(ESWifiConnTab[index].LocalPort).End();
         ret = AT_ExecuteCommand();
       }
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_TR_SET_REMOTE_PORT_NUMBER, ESWifiConnTab[index].RemotePort,
-              SUFFIX_CMD);
+      Cmd.Start(AT_TR_SET_REMOTE_PORT_NUMBER).Char('=').Int(ESWifiConnTab[index].RemotePort).End();
 
       ret = AT_ExecuteCommand();
 
       if (ret == ES_WIFI_STATUS_OK) {
-        sprintf((char *)EsWifiObj.CmdData, "%s=%d.%d.%d.%d%s",
-                AT_TR_SET_REMOTE_HOST_IP_ADDR,
-                ESWifiConnTab[index].RemoteIP[0], ESWifiConnTab[index].RemoteIP[1],
-                ESWifiConnTab[index].RemoteIP[2], ESWifiConnTab[index].RemoteIP[3],
-                SUFFIX_CMD);
+        Cmd.Start(AT_TR_SET_REMOTE_HOST_IP_ADDR).Char('=').Ip(ESWifiConnTab[index].RemoteIP).End();
         ret = AT_ExecuteCommand();
 
         if (ret == ES_WIFI_STATUS_OK) {
-          sprintf((char *)EsWifiObj.CmdData, "%s=1%s",
-                  AT_TR_CLIENT, SUFFIX_CMD);
-          ret = AT_ExecuteCommand();
+          Cmd.Start(AT_TR_CLIENT).Text("=1").End();
+          ret = AT_ExecuteCommand(ES_WIFI_CMD_DNS);
         }
       }
     }
   }
+#if ES_WIFI_RECOVERY
+  if (ret == ES_WIFI_STATUS_OK) {
+    Recovery.ClientSockets |= (1 << index);
+  } else {
+    Recovery.ClientSockets &= ~(1 << index);
+  }
+#endif
   return (ret == ES_WIFI_STATUS_OK);
 }
 
@@ -1405,14 +2020,15 @@ bool IsmDrvClass::ES_WIFI_StopClientConnection(uint8_t index)
 
   currentSock = index;
   sockState[currentSock] = SOCKET_FREE;
-  sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-          AT_TR_SET_SOCKET, index, SUFFIX_CMD);
-  ret = AT_ExecuteCommand();
+  AT_ClearBuffers(currentSock);
+#if ES_WIFI_RECOVERY
+  Recovery.ClientSockets &= ~(1 << index);
+#endif
+  ret = AT_SelectSocket(index);
 
   if (ret == ES_WIFI_STATUS_OK) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=0%s",
-            AT_TR_CLIENT, SUFFIX_CMD);
-    ret =  AT_ExecuteCommand();
+    Cmd.Start(AT_TR_CLIENT).Text("=0").End();
+    ret =  AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
   }
   return (ret == ES_WIFI_STATUS_OK);
 }
@@ -1428,53 +2044,47 @@ void IsmDrvClass::ES_WIFI_StartServerSingleConn(uint8_t index, comm_mode mode)
   ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
   char *ptr;
 
+  AT_Recover();
   if (index <= MAX_SOCK_NUM) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=1,3000%s",
-            AT_TR_TCP_KEEP_ALIVE, SUFFIX_CMD);
+    Cmd.Start(AT_TR_TCP_KEEP_ALIVE).Text("=1,3000").End();
     ret = AT_ExecuteCommand();
     if (ret == ES_WIFI_STATUS_OK) {
       currentSock = index;
+      /* Restarted while serving a client: keep its data */
+      if (sockState[currentSock] != SOCKET_BUSY) {
+        AT_ClearBuffers(currentSock);
+      }
       sockState[currentSock] = SOCKET_BUSY;
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_TR_SET_SOCKET, ESWifiConnTab[index].Number, SUFFIX_CMD);
-      ret = AT_ExecuteCommand();
+      ret = AT_SelectSocket(ESWifiConnTab[index].Number);
       if (ret == ES_WIFI_STATUS_OK) {
-        sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-                AT_TR_SET_PROTOCOL, ESWifiConnTab[index].Type, SUFFIX_CMD);
+        Cmd.Start(AT_TR_SET_PROTOCOL).Char('=').Int(ESWifiConnTab[index].Type).End();
         ret = AT_ExecuteCommand();
         if (ret == ES_WIFI_STATUS_OK) {
-          sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-                  AT_TR_SET_LOCAL_PORT_NUMBER, ESWifiConnTab[index].LocalPort, SUFFIX_CMD);
+          Cmd.Start(AT_TR_SET_LOCAL_PORT_NUMBER).Char('=').Int(ESWifiConnTab[index].LocalPort).End();
           ret = AT_ExecuteCommand();
           if (ret == ES_WIFI_STATUS_OK) {
-            sprintf((char *)EsWifiObj.CmdData, "%s=1%s",
-                    AT_TR_SERVER, SUFFIX_CMD);
-            ret = AT_ExecuteCommand();
+            Cmd.Start(AT_TR_SERVER).Text("=1").End();
+            ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
 
             if (ret == ES_WIFI_STATUS_OK) {
               if (mode == COMM_UART) {
-                if (Drv->IO_Receive(EsWifiObj.CmdData, 0, EsWifiObj.Timeout) > 0) {
+                if (Drv->IO_Receive(EsWifiObj.CmdData, 0, Timeouts[ES_WIFI_CMD_CONFIG].Max) > 0) {
                   if (strstr((char *)EsWifiObj.CmdData, "Accepted")) {
-                    ptr = strtok((char *)EsWifiObj.CmdData + 2, " ");
-                    ptr = strtok(NULL, " ");
-                    ptr = strtok(NULL, " ");
-                    ptr = strtok(NULL, ":");
+                    /* "Accepted <address>:<port>" */
+                    ptr = strstr((char *)EsWifiObj.CmdData, "Accepted") + strlen("Accepted ");
                     ParseIP((char *)ptr, ESWifiConnTab[index].RemoteIP);
                     ret = ES_WIFI_STATUS_OK;
                   }
                 }
               } else if (mode == COMM_SPI) {
                 do {
-                  strcpy((char *)EsWifiObj.CmdData, AT_MESSAGE_READ);
-                  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-                  ret = AT_ExecuteCommand();
+                  Cmd.Start(AT_MESSAGE_READ).End();
+                  ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
                   if (ret == ES_WIFI_STATUS_OK) {
                     if ((strstr((char *)EsWifiObj.CmdData, "[SOMA]")) && (strstr((char *)EsWifiObj.CmdData, "[EOMA]"))) {
                       if (strstr((char *)EsWifiObj.CmdData, "Accepted")) {
-                        ptr = strtok((char *)EsWifiObj.CmdData + 2, " ");
-                        ptr = strtok(NULL, " ");
-                        ptr = strtok(NULL, " ");
-                        ptr = strtok(NULL, ":");
+                        /* "Accepted <address>:<port>" */
+                        ptr = strstr((char *)EsWifiObj.CmdData, "Accepted") + strlen("Accepted ");
                         ParseIP((char *)ptr, ESWifiConnTab[index].RemoteIP);
                         ret = ES_WIFI_STATUS_OK;
                         break;
@@ -1508,13 +2118,11 @@ void IsmDrvClass::ES_WIFI_StopServerSingleConn(uint8_t index)
 
   currentSock = index;
   sockState[currentSock] = SOCKET_FREE;
-  sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-          AT_TR_SET_SOCKET, index, SUFFIX_CMD);
-  ret = AT_ExecuteCommand();
+  AT_ClearBuffers(currentSock);
+  ret = AT_SelectSocket(index);
   if (ret == ES_WIFI_STATUS_OK) {
-    sprintf((char *)EsWifiObj.CmdData, "%s=0%s",
-            AT_TR_SERVER, SUFFIX_CMD);
-    AT_ExecuteCommand();
+    Cmd.Start(AT_TR_SERVER).Text("=0").End();
+    AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
   }
 }
 
@@ -1530,59 +2138,50 @@ void IsmDrvClass::ES_WIFI_StartServerMultiConn(uint8_t index, comm_mode mode)
   ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
   char *ptr;
 
-  sprintf((char *)EsWifiObj.CmdData, "%s=1,3000%s",
-          AT_TR_TCP_KEEP_ALIVE, SUFFIX_CMD);
+  AT_Recover();
+  Cmd.Start(AT_TR_TCP_KEEP_ALIVE).Text("=1,3000").End();
   ret = AT_ExecuteCommand();
   if (ret == ES_WIFI_STATUS_OK) {
     currentSock = index;
+    /* Restarted while serving a client: keep its data */
+    if (sockState[currentSock] != SOCKET_BUSY) {
+      AT_ClearBuffers(currentSock);
+    }
     sockState[currentSock] = SOCKET_BUSY;
-    sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-            AT_TR_SET_SOCKET, ESWifiConnTab[index].Number, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+    ret = AT_SelectSocket(ESWifiConnTab[index].Number);
     if (ret == ES_WIFI_STATUS_OK) {
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_TR_SET_PROTOCOL, ESWifiConnTab[index].Type, SUFFIX_CMD);
+      Cmd.Start(AT_TR_SET_PROTOCOL).Char('=').Int(ESWifiConnTab[index].Type).End();
       ret = AT_ExecuteCommand();
       if (ret == ES_WIFI_STATUS_OK) {
-        sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-                AT_TR_SET_LOCAL_PORT_NUMBER, ESWifiConnTab[index].LocalPort,
-                SUFFIX_CMD);
+        Cmd.Start(AT_TR_SET_LOCAL_PORT_NUMBER).Char('=').Int(ESWifiConnTab[index].LocalPort).End();
         ret = AT_ExecuteCommand();
         if (ret == ES_WIFI_STATUS_OK) {
-          sprintf((char *)EsWifiObj.CmdData, "%s=6%s",
-                  AT_TR_SET_LISTEN_BACKLOGS, SUFFIX_CMD);
+          Cmd.Start(AT_TR_SET_LISTEN_BACKLOGS).Text("=6").End();
           ret = AT_ExecuteCommand();
 
           if (ret == ES_WIFI_STATUS_OK) {
-            strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-            sprintf((char *)EsWifiObj.CmdData, "%s=1%s",
-                    AT_TR_SERVER, SUFFIX_CMD);
-            ret = AT_ExecuteCommand();
+            Cmd.Start(AT_TR_SERVER).Text("=1").End();
+            ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
 
             if (ret == ES_WIFI_STATUS_OK) {
               if (mode == COMM_UART) {
-                if (Drv->IO_Receive(EsWifiObj.CmdData, 0, EsWifiObj.Timeout) > 0) {
+                if (Drv->IO_Receive(EsWifiObj.CmdData, 0, Timeouts[ES_WIFI_CMD_CONFIG].Max) > 0) {
                   if (strstr((char *)EsWifiObj.CmdData, "Accepted")) {
-                    ptr = strtok((char *)EsWifiObj.CmdData + 2, " ");
-                    ptr = strtok(NULL, " ");
-                    ptr = strtok(NULL, " ");
-                    ptr = strtok(NULL, ":");
+                    /* "Accepted <address>:<port>" */
+                    ptr = strstr((char *)EsWifiObj.CmdData, "Accepted") + strlen("Accepted ");
                     ParseIP((char *)ptr, ESWifiConnTab[index].RemoteIP);
                     ret = ES_WIFI_STATUS_OK;
                   }
                 }
               } else if (mode == COMM_SPI) {
                 do {
-                  strcpy((char *)EsWifiObj.CmdData, AT_MESSAGE_READ);
-                  strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-                  ret = AT_ExecuteCommand();
+                  Cmd.Start(AT_MESSAGE_READ).End();
+                  ret = AT_ExecuteCommand(ES_WIFI_CMD_SLOW);
                   if (ret == ES_WIFI_STATUS_OK) {
                     if ((strstr((char *)EsWifiObj.CmdData, "[SOMA]")) && (strstr((char *)EsWifiObj.CmdData, "[EOMA]"))) {
                       if (strstr((char *)EsWifiObj.CmdData, "Accepted")) {
-                        ptr = strtok((char *)EsWifiObj.CmdData + 2, " ");
-                        ptr = strtok(NULL, " ");
-                        ptr = strtok(NULL, " ");
-                        ptr = strtok(NULL, ":");
+                        /* "Accepted <address>:<port>" */
+                        ptr = strstr((char *)EsWifiObj.CmdData, "Accepted") + strlen("Accepted ");
                         ParseIP((char *)ptr, ESWifiConnTab[index].RemoteIP);
                         ret = ES_WIFI_STATUS_OK;
                         break;
@@ -1599,8 +2198,7 @@ void IsmDrvClass::ES_WIFI_StartServerMultiConn(uint8_t index, comm_mode mode)
               }
             }
             if (ret == ES_WIFI_STATUS_OK) {
-              sprintf((char *)EsWifiObj.CmdData, "%s=1%s",
-                      AT_TR_REQUEST_TCP_LOOP, SUFFIX_CMD);
+              Cmd.Start(AT_TR_REQUEST_TCP_LOOP).Text("=1").End();
               ret = AT_ExecuteCommand();
 
             }
@@ -1609,6 +2207,8 @@ void IsmDrvClass::ES_WIFI_StartServerMultiConn(uint8_t index, comm_mode mode)
       }
     }
   }
+  /* The module may have switched to the socket of another request */
+  AT_InvalidateParams();
 }
 
 /**
@@ -1621,18 +2221,17 @@ void IsmDrvClass::ES_WIFI_StopServerMultiConn()
   ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
 
   /* close the socket handle for the current request. */
-  sprintf((char *)EsWifiObj.CmdData, "%s=2%s",
-          AT_TR_REQUEST_TCP_LOOP, SUFFIX_CMD);
+  AT_ClearBuffers(currentSock);
+  Cmd.Start(AT_TR_REQUEST_TCP_LOOP).Text("=2").End();
   ret =  AT_ExecuteCommand();
 
   if (ret == ES_WIFI_STATUS_OK) {
     /*Get the next request out of the queue */
-    sprintf((char *)EsWifiObj.CmdData, "%s=3%s",
-            AT_TR_REQUEST_TCP_LOOP, SUFFIX_CMD);
+    Cmd.Start(AT_TR_REQUEST_TCP_LOOP).Text("=3").End();
     ret = AT_ExecuteCommand();
     if (ret == ES_WIFI_STATUS_OK) {
       if (ret == ES_WIFI_STATUS_OK) {
-        if (Drv->IO_Receive(EsWifiObj.CmdData, 0, EsWifiObj.Timeout) > 0) {
+        if (Drv->IO_Receive(EsWifiObj.CmdData, 0, Timeouts[ES_WIFI_CMD_CONFIG].Max) > 0) {
           if (strstr((char *)EsWifiObj.CmdData, "Accepted")) {
             ret = ES_WIFI_STATUS_OK;
           }
@@ -1640,104 +2239,375 @@ void IsmDrvClass::ES_WIFI_StopServerMultiConn()
       }
     }
   }
+  /* The module may have switched to the socket of another request */
+  AT_InvalidateParams();
 }
 
 /**
   * @brief  Send an amount data over WIFI.
+  *         Data longer than ES_WIFI_PAYLOAD_SIZE are sent in payload-sized
+  *         chunks, until all are sent or a chunk fails.
   * @param  Socket  : number of the socket
   * @param  pdata   : pointer to data
-  * @param  len     : length of the data to be sent
-  * @param  SentLen : length of data really send
-  * @param  Timeout : Timeout for sending data in ms (range of 0 to 30000)
+  * @param  Reqlen  : length of the data to be sent
+  * @param  SentLen : length of data really send, the chunks sent before a
+  *                   failure included
+  * @param  Timeout : Timeout for sending each chunk in ms (range of 0 to 30000)
   * @retval None.
   */
 void IsmDrvClass::ES_WIFI_SendResp(uint8_t Socket, uint8_t *pdata,
-                                   uint16_t Reqlen, uint16_t *SentLen, uint32_t Timeout)
+                                   size_t Reqlen, size_t *SentLen, uint32_t Timeout)
 {
-  ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
+  ES_WIFI_Status_t ret;
+  uint16_t len;
 
   if ((pdata == NULL) || (SentLen == NULL)) {
     return;
   }
 
-  if (Reqlen <= ES_WIFI_PAYLOAD_SIZE) {
-    currentSock = Socket;
-    sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-            AT_TR_SET_SOCKET, Socket, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+  AT_Recover();
+  *SentLen = 0;
+  currentSock = Socket;
+  ret = AT_SelectSocket(Socket);
+  if (ret == ES_WIFI_STATUS_OK) {
+    ES_WIFI_SetTimeout(Timeout);
+    // Timeout for the device must be shorter than our timeout otherwise
+    // the device may answer to late.
+    ret = AT_SetParam(AT_WRITE_SET_TIMEOUT, Timeout - TIMEOUT_OFFSET, &Params.WriteTimeout);
+  }
+
+  while ((ret == ES_WIFI_STATUS_OK) && (*SentLen < Reqlen)) {
+    len = ((Reqlen - *SentLen) > ES_WIFI_PAYLOAD_SIZE) ?
+          ES_WIFI_PAYLOAD_SIZE : (uint16_t)(Reqlen - *SentLen);
+    if (writeWithLength) {
+      // The length is given with the data: no packet size to set
+      Cmd.Start(AT_WRITE_DATA_WITH_LENGTH).Char('=').Uint(len, 4).End();
+      Params.WritePacketSize = ES_WIFI_PARAM_UNKNOWN;
+    } else {
+      // Skipped for the full chunks after the first one
+      ret = AT_SetParam(AT_WRITE_SET_PACKET_SIZE, len, &Params.WritePacketSize);
+      Cmd.Start(AT_WRITE_DATA).End();
+    }
     if (ret == ES_WIFI_STATUS_OK) {
-      ES_WIFI_SetTimeout(Timeout);
-      // Timeout for the device must be shorter than our timeout otherwise
-      // the device may answer to late.
-      sprintf((char *)EsWifiObj.CmdData, "%s=%lu%s",
-              AT_WRITE_SET_TIMEOUT, Timeout - TIMEOUT_OFFSET, SUFFIX_CMD);
-      ret = AT_ExecuteCommand();
+      ret = AT_RequestSendData(Cmd.Data(), Cmd.Length(), pdata + *SentLen, len);
       if (ret == ES_WIFI_STATUS_OK) {
-        sprintf((char *)EsWifiObj.CmdData, "%s=%u%s",
-                AT_WRITE_SET_PACKET_SIZE, Reqlen, SUFFIX_CMD);
-        ret = AT_ExecuteCommand();
-        if (ret == ES_WIFI_STATUS_OK) {
-          strcpy((char *)EsWifiObj.CmdData, AT_WRITE_DATA);
-          strcat((char *)EsWifiObj.CmdData, SUFFIX_CMD);
-          memcpy((char *)EsWifiObj.CmdData + 3, pdata, Reqlen);
-          ret = AT_RequestSendData(EsWifiObj.CmdData, Reqlen + 3, EsWifiObj.CmdData);
-          if (ret == ES_WIFI_STATUS_OK) {
-            *SentLen = Reqlen;
-          } else {
-            *SentLen = 0;
-          }
-        }
+        *SentLen += len;
+      } else {
+        AT_InvalidateParams();
       }
     }
   }
 }
 
+/**
+  * @brief  Write data to a socket. Writes shorter than the send buffer are
+  *         gathered in it; it is sent when full or when its first byte is
+  *         older than ES_WIFI_TX_LINGER ms.
+  * @param  Socket  : number of the socket
+  * @param  pdata   : pointer to data
+  * @param  Reqlen  : length of the data to be sent
+  * @param  SentLen : length of data sent or buffered. The buffered data may
+  *                   still fail to be sent: ES_WIFI_Flush reports it.
+  * @param  Timeout : Timeout for sending data in ms (range of 0 to 30000)
+  * @retval None.
+  */
+void IsmDrvClass::ES_WIFI_Write(uint8_t Socket, uint8_t *pdata,
+                                size_t Reqlen, size_t *SentLen, uint32_t Timeout)
+{
+#if ES_WIFI_SOCKET_TX_BUFFER_SIZE > 0
+  ES_WIFI_TxBuffer_t *tx;
+
+  if ((pdata == NULL) || (SentLen == NULL)) {
+    return;
+  }
+  if (Socket >= MAX_SOCK_NUM) {
+    ES_WIFI_SendResp(Socket, pdata, Reqlen, SentLen, Timeout);
+    return;
+  }
+
+  tx = &TxBuffer[Socket];
+  *SentLen = 0;
+  if ((tx->Len > 0) && ((tx->Len + Reqlen) > ES_WIFI_SOCKET_TX_BUFFER_SIZE)) {
+    if (!ES_WIFI_Flush(Socket, false)) {
+      return;
+    }
+  }
+  if (Reqlen >= ES_WIFI_SOCKET_TX_BUFFER_SIZE) {
+    ES_WIFI_SendResp(Socket, pdata, Reqlen, SentLen, Timeout);
+    return;
+  }
+
+  if (tx->Len == 0) {
+    tx->Start = millis();
+  }
+  memcpy(tx->Data + tx->Len, pdata, Reqlen);
+  tx->Len += Reqlen;
+  tx->Timeout = Timeout;
+  *SentLen = Reqlen;
+  if (tx->Len == ES_WIFI_SOCKET_TX_BUFFER_SIZE) {
+    ES_WIFI_Flush(Socket, false);
+  } else {
+    ES_WIFI_Flush(Socket, true);
+  }
+#else
+  ES_WIFI_SendResp(Socket, pdata, Reqlen, SentLen, Timeout);
+#endif
+}
+
+/**
+  * @brief  Send the data gathered by ES_WIFI_Write.
+  * @param  Socket  : number of the socket
+  * @param  expired : true to send them only when the first byte is older than
+  *                   ES_WIFI_TX_LINGER ms
+  * @retval false if some data could not be sent, they are kept, or if they
+  *         were dropped while being sent.
+  */
+bool IsmDrvClass::ES_WIFI_Flush(uint8_t Socket, bool expired)
+{
+#if ES_WIFI_SOCKET_TX_BUFFER_SIZE > 0
+  ES_WIFI_TxBuffer_t *tx;
+  size_t sent = 0;
+  uint16_t len;
+
+  if (Socket >= MAX_SOCK_NUM) {
+    return true;
+  }
+  tx = &TxBuffer[Socket];
+  if ((tx->Len == 0) || (expired && ((millis() - tx->Start) < ES_WIFI_TX_LINGER))) {
+    return true;
+  }
+
+  len = tx->Len;
+  ES_WIFI_SendResp(Socket, tx->Data, len, &sent, tx->Timeout);
+  if (tx->Len != len) {
+    /* The buffer was cleared meanwhile: the socket was closed */
+    return false;
+  }
+  if (sent < len) {
+    memmove(tx->Data, tx->Data + sent, len - sent);
+    tx->Len -= sent;
+    return false;
+  }
+  tx->Len = 0;
+  return true;
+#else
+  UNUSED(Socket);
+  UNUSED(expired);
+  return true;
+#endif
+}
+
 /**
   * @brief  Receive an amount data over WIFI.
+  *         The data read ahead are returned first, without reading the
+  *         module. When there are none, a request shorter than the read-ahead
+  *         buffer fills it with one read of its size, longer ones are read
+  *         straight into pdata.
+  *         UDP sockets are always read straight into pdata.
   * @param  Socket      : number of the socket
   * @param  pdata       : pointer to data
-  * @param  Reqlen      : pointer to the length of the data to be received
+  * @param  Reqlen      : length of the data to be received
   * @param  Receivedlen : Number of data really recieved
   * @param  timeout     : Timeout for receiving the data
   * @retval None.
   */
 void IsmDrvClass::ES_WIFI_ReceiveData(uint8_t Socket, uint8_t *pdata,
-                                      uint16_t Reqlen, uint16_t *Receivedlen, uint32_t Timeout)
+                                      size_t Reqlen, size_t *Receivedlen, uint32_t Timeout)
 {
-  ES_WIFI_Status_t ret = ES_WIFI_STATUS_ERROR;
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+  ES_WIFI_RxBuffer_t *rx;
+  size_t len;
 
   if ((pdata == NULL) || (Receivedlen == NULL)) {
     return;
   }
+  /* A read-ahead would merge the datagrams of an UDP socket */
+  if ((Socket >= MAX_SOCK_NUM) || (ESWifiConnTab[Socket].Type == ES_WIFI_UDP_CONNECTION)) {
+    AT_ReceiveSocketData(Socket, pdata, Reqlen, Receivedlen, Timeout);
+    return;
+  }
+  /* The peer may wait for them to answer */
+  ES_WIFI_Flush(Socket, false);
 
-  if (Reqlen <= ES_WIFI_PAYLOAD_SIZE) {
-    currentSock = Socket;
-    sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-            AT_TR_SET_SOCKET, Socket, SUFFIX_CMD);
-    ret = AT_ExecuteCommand();
+  rx = &RxBuffer[Socket];
+  if (rx->Pos == rx->Len) {
+    if (Reqlen >= ES_WIFI_SOCKET_RX_BUFFER_SIZE) {
+      AT_ReceiveSocketData(Socket, pdata, Reqlen, Receivedlen, Timeout);
+      return;
+    }
+    AT_FillRxBuffer(Socket, Timeout);
+  }
 
-    if (ret == ES_WIFI_STATUS_OK) {
-      sprintf((char *)EsWifiObj.CmdData, "%s=%d%s",
-              AT_READ_SET_PACKET_SIZE, Reqlen, SUFFIX_CMD);
-      ret = AT_ExecuteCommand();
-      if (ret == ES_WIFI_STATUS_OK) {
-        // Timeout for the device must be shorter than our timeout otherwise
-        // the device may answer too late.
-        ES_WIFI_SetTimeout(Timeout);
-        sprintf((char *)EsWifiObj.CmdData, "%s=%lu%s",
-                AT_READ_SET_TIMEOUT_MS, Timeout - TIMEOUT_OFFSET, SUFFIX_CMD);
-        ret = AT_ExecuteCommand();
-        if (ret == ES_WIFI_STATUS_OK) {
-          sprintf((char *)EsWifiObj.CmdData, AT_READ_DATA);
-          ret = AT_RequestReceiveData(EsWifiObj.CmdData, (char *)pdata, Reqlen, Receivedlen);
-          if (ret != ES_WIFI_STATUS_OK) {
-            sockState[Socket] = SOCKET_FREE;
-            *Receivedlen = 0;
-          }
-        }
-      } else {
-        *Receivedlen = 0;
+  len = rx->Len - rx->Pos;
+  if (len > Reqlen) {
+    len = Reqlen;
+  }
+  memcpy(pdata, rx->Data + rx->Pos, len);
+  rx->Pos += len;
+  *Receivedlen = len;
+#else
+  ES_WIFI_Flush(Socket, false);
+  AT_ReceiveSocketData(Socket, pdata, Reqlen, Receivedlen, Timeout);
+#endif
+}
+
+/**
+  * @brief  Get the number of bytes which can be read without waiting. When
+  *         none are buffered, the module is read with the short
+  *         ES_WIFI_PREFETCH_TIMEOUT.
+  * @param  Socket : number of the socket
+  * @retval number of bytes buffered, 1 when there is no read-ahead buffer
+  *         to tell, as for the UDP sockets.
+  */
+int IsmDrvClass::ES_WIFI_Available(uint8_t Socket)
+{
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+  ES_WIFI_RxBuffer_t *rx;
+
+  if (Socket >= MAX_SOCK_NUM) {
+    return 0;
+  }
+  if (ESWifiConnTab[Socket].Type == ES_WIFI_UDP_CONNECTION) {
+    /* Not read ahead: ES_WIFI_ReceiveData would not serve the data */
+    return 1;
+  }
+  rx = &RxBuffer[Socket];
+  if ((rx->Pos == rx->Len) && (sockState[Socket] == SOCKET_BUSY)) {
+    ES_WIFI_Flush(Socket, false);
+    AT_FillRxBuffer(Socket, ES_WIFI_PREFETCH_TIMEOUT);
+  }
+  return rx->Len - rx->Pos;
+#else
+  UNUSED(Socket);
+  return 1;
+#endif
+}
+
+/**
+  * @brief  Get the next byte of a socket without consuming it. When none is
+  *         buffered, the module is read as by ES_WIFI_Available.
+  * @param  Socket : number of the socket
+  * @retval next byte, -1 if none is available or the socket is UDP.
+  */
+int IsmDrvClass::ES_WIFI_Peek(uint8_t Socket)
+{
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+  if ((Socket >= MAX_SOCK_NUM) || (ESWifiConnTab[Socket].Type == ES_WIFI_UDP_CONNECTION)) {
+    return -1;
+  }
+  if (ES_WIFI_Available(Socket) <= 0) {
+    return -1;
+  }
+  return RxBuffer[Socket].Data[RxBuffer[Socket].Pos];
+#else
+  UNUSED(Socket);
+  return -1;
+#endif
+}
+
+/**
+  * @brief  Fill the empty read-ahead buffer of a socket with one read.
+  * @param  Socket  : number of the socket
+  * @param  Timeout : Timeout for receiving the data
+  * @retval None.
+  */
+void IsmDrvClass::AT_FillRxBuffer(uint8_t Socket, uint32_t Timeout)
+{
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+  size_t len = 0;
+
+  AT_ReceiveSocketData(Socket, RxBuffer[Socket].Data, ES_WIFI_SOCKET_RX_BUFFER_SIZE, &len, Timeout);
+  RxBuffer[Socket].Pos = 0;
+  RxBuffer[Socket].Len = len;
+#else
+  UNUSED(Socket);
+  UNUSED(Timeout);
+#endif
+}
+
+/**
+  * @brief  Drop the data read ahead from a socket and the data not sent yet.
+  * @param  socket : number of the socket
+  * @retval None.
+  */
+void IsmDrvClass::AT_ClearBuffers(uint8_t socket)
+{
+  if (socket >= MAX_SOCK_NUM) {
+    return;
+  }
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+  RxBuffer[socket].Pos = 0;
+  RxBuffer[socket].Len = 0;
+#endif
+#if ES_WIFI_SOCKET_TX_BUFFER_SIZE > 0
+  TxBuffer[socket].Len = 0;
+#endif
+}
+
+/**
+  * @brief  Receive an amount data from the module.
+  *         Requests longer than ES_WIFI_PAYLOAD_SIZE are served by
+  *         consecutive reads until the buffer is full, the timeout expires or
+  *         a read returns less than asked, when the peer has no more data.
+  *         The module waits for the data Timeout - TIMEOUT_OFFSET ms. This
+  *         read timeout is only sent when it differs from the last one, when
+  *         a prefetch and a blocking read follow each other.
+  * @param  Socket      : number of the socket
+  * @param  pdata       : pointer to data
+  * @param  Reqlen      : length of the data to be received
+  * @param  Receivedlen : Number of data really recieved
+  * @param  timeout     : Timeout for receiving the data
+  * @retval None.
+  */
+void IsmDrvClass::AT_ReceiveSocketData(uint8_t Socket, uint8_t *pdata,
+                                       size_t Reqlen, size_t *Receivedlen, uint32_t Timeout)
+{
+  ES_WIFI_Status_t ret;
+  uint16_t len;
+  uint16_t ReadData;
+  uint32_t start = millis();
+
+  if ((pdata == NULL) || (Receivedlen == NULL)) {
+    return;
+  }
+
+  AT_Recover();
+  *Receivedlen = 0;
+  currentSock = Socket;
+  ret = AT_SelectSocket(Socket);
+  if (ret == ES_WIFI_STATUS_OK) {
+    // Timeout for the device must be shorter than our timeout otherwise
+    // the device may answer too late.
+    ES_WIFI_SetTimeout(Timeout);
+    ret = AT_SetParam(AT_READ_SET_TIMEOUT_MS, Timeout - TIMEOUT_OFFSET, &Params.ReadTimeout);
+  }
+
+  while (ret == ES_WIFI_STATUS_OK) {
+    len = ((Reqlen - *Receivedlen) > ES_WIFI_PAYLOAD_SIZE) ?
+          ES_WIFI_PAYLOAD_SIZE : (uint16_t)(Reqlen - *Receivedlen);
+    // Only sent for the first chunk and for a shorter last one
+    ret = AT_SetParam(AT_READ_SET_PACKET_SIZE, len, &Params.ReadPacketSize);
+    if (ret != ES_WIFI_STATUS_OK) {
+      break;
+    }
+    Cmd.Start(AT_READ_DATA);
+    ret = AT_RequestReceiveData(Cmd.Data(), Cmd.Length(), (char *)pdata + *Receivedlen, len, &ReadData);
+    if (ret != ES_WIFI_STATUS_OK) {
+      AT_InvalidateParams();
+#if ES_WIFI_RECOVERY
+      /* Without answer, the socket is left to the recovery, if enabled */
+      if ((ret != ES_WIFI_STATUS_IO_ERROR) || !Recovery.Enabled) {
+        sockState[Socket] = SOCKET_FREE;
+        Recovery.ClientSockets &= ~(1 << Socket);
       }
+#else
+      sockState[Socket] = SOCKET_FREE;
+#endif
+      break;
+    }
+    *Receivedlen += ReadData;
+    if ((ReadData < len) || (*Receivedlen >= Reqlen) || ((millis() - start) >= Timeout)) {
+      break;
     }
   }
 }
@@ -1830,4 +2700,299 @@ uint8_t IsmDrvClass::getSocketState(uint8_t socket)
   }
 }
 
+/**
+  * @brief  Get the statistics of the exchanges with the module
+  * @param  stats: where to copy the counters
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_GetIOStats(IO_Stats_t *stats)
+{
+  Drv->IO_GetStats(stats);
+}
+
+/**
+  * @brief  Reset the statistics of the exchanges with the module
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_ResetIOStats()
+{
+  Drv->IO_ResetStats();
+}
+
+/**
+  * @brief  Set the chip select timing (SPI only)
+  * @param  setup_us: delay between select and the first clock, in us
+  * @param  hold_us: delay after deselect, in us
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_SetCSTiming(uint16_t setup_us, uint16_t hold_us)
+{
+  Drv->IO_SetCSTiming(setup_us, hold_us);
+}
+
+/**
+  * @brief  Change the baud rate of the module UART and of the link.
+  * @param  BaudRate: new baud rate
+  * @retval Operation Status.
+  */
+ES_WIFI_Status_t IsmDrvClass::AT_SetUARTBaudRate(uint32_t BaudRate)
+{
+  ES_WIFI_Status_t ret;
+  int16_t len;
+
+  Cmd.Start(AT_UART_SET_BAUDRATE).Char('=').Uint(BaudRate).End();
+  ret = AT_ExecuteCommand();
+  if (ret == ES_WIFI_STATUS_OK) {
+    /* The new settings are applied by U0, the answer comes at the new rate */
+    Cmd.Start(AT_UART_ENABLE).End();
+    PRINTDATA(Cmd.Data(), Cmd.Length());
+    if (Drv->IO_Send(Cmd.Data(), Cmd.Length(), Timeouts[ES_WIFI_CMD_CONFIG].Max) < 0) {
+      return ES_WIFI_STATUS_IO_ERROR;
+    }
+    Drv->IO_SetSpeed(BaudRate);
+    len = Drv->IO_Receive(EsWifiObj.CmdData, ES_WIFI_DATA_SIZE - 1, Timeouts[ES_WIFI_CMD_CONFIG].Max);
+    if (len <= 0) {
+      return ES_WIFI_STATUS_IO_ERROR;
+    }
+    EsWifiObj.CmdData[len] = 0;
+    PRINTDATA(EsWifiObj.CmdData, len);
+    Framer.Reset();
+    if (Framer.Feed(EsWifiObj.CmdData, len) == AT_FRAME_ERROR) {
+      return ES_WIFI_STATUS_ERROR;
+    }
+  }
+  return ret;
+}
+
+/**
+  * @brief  Set the bus speed. On SPI, fastest clock tried at next init. On
+  *         UART, baud rate of the link: once the module is initialized, its
+  *         UART is reconfigured (U2 command) before the link.
+  * @param  speed: SPI clock or UART baud rate in Hz
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_SetIOSpeed(uint32_t speed)
+{
+  if ((commMode == COMM_UART) && (Drv->IO_GetSpeed() != 0)) {
+    AT_SetUARTBaudRate(speed);
+  } else {
+    Drv->IO_SetSpeed(speed);
+  }
+}
+
+/**
+  * @brief  Get the bus speed negotiated at init
+  * @param  None
+  * @retval SPI clock or UART baud rate in Hz, 0 if the module is not
+  *         initialized
+  */
+uint32_t IsmDrvClass::ES_WIFI_GetIOSpeed()
+{
+  return Drv->IO_GetSpeed();
+}
+
+/**
+  * @brief  Select how the module is initialized
+  * @param  enable: true to use the module if it is already running, false
+  *         to always reset it
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_SetWarmStart(bool enable)
+{
+  warmStart = enable;
+}
+
+/**
+  * @brief  Get the duration of the last successful init
+  * @param  None
+  * @retval time from the start of ES_WIFI_Init to the module answer in ms
+  */
+uint32_t IsmDrvClass::ES_WIFI_GetBootTime()
+{
+  return bootTime;
+}
+
+/**
+  * @brief  Set the timeout of a class of commands
+  * @param  cmdClass: class of commands
+  * @param  timeout: timeout in ms
+  * @param  adaptive: true to shorten the timeout to the observed latency,
+  *         ignored for the socket data which follow the socket timeout
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_SetCmdTimeout(ES_WIFI_CmdClass_t cmdClass, uint32_t timeout, bool adaptive)
+{
+  if (cmdClass >= ES_WIFI_CMD_CLASSES) {
+    return;
+  }
+  Timeouts[cmdClass].Max = timeout;
+  Timeouts[cmdClass].Current = timeout;
+  Timeouts[cmdClass].Srtt = 0;
+  Timeouts[cmdClass].RttVar = 0;
+  Timeouts[cmdClass].Adaptive = adaptive && (cmdClass != ES_WIFI_CMD_DATA);
+}
+
+/**
+  * @brief  Get the timeout in use for a class of commands
+  * @param  cmdClass: class of commands
+  * @retval timeout in ms
+  */
+uint32_t IsmDrvClass::ES_WIFI_GetCmdTimeout(ES_WIFI_CmdClass_t cmdClass)
+{
+  if (cmdClass >= ES_WIFI_CMD_CLASSES) {
+    return 0;
+  }
+  return Timeouts[cmdClass].Current;
+}
+
+/**
+  * @brief  Get a latency histogram
+  * @param  index: index of the command, from 0
+  * @param  hist: copy of the histogram
+  * @retval false if no command has this index
+  */
+bool IsmDrvClass::ES_WIFI_GetLatency(uint8_t index, ES_WIFI_Latency_t *hist)
+{
+#if ES_WIFI_LATENCY_STATS
+  if ((hist == NULL) || (index >= ES_WIFI_LATENCY_CMDS) || (Latency[index].Cmd[0] == 0)) {
+    return false;
+  }
+  *hist = Latency[index];
+  return true;
+#else
+  UNUSED(index);
+  UNUSED(hist);
+  return false;
+#endif
+}
+
+/**
+  * @brief  Clear the latency histograms
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_ResetLatency()
+{
+#if ES_WIFI_LATENCY_STATS
+  memset(Latency, 0, sizeof(Latency));
+#endif
+}
+
+/**
+  * @brief  Enable or disable the recovery of the module when it stops
+  *         answering
+  * @param  enable: true to recover the module
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_SetRecovery(bool enable)
+{
+#if ES_WIFI_RECOVERY
+  Recovery.Enabled = enable;
+  Recovery.Failures = 0;
+  Recovery.Pending = false;
+  Recovery.Backoff = 0;
+#else
+  UNUSED(enable);
+#endif
+}
+
+/**
+  * @brief  Get the counters of the recovery of the module
+  * @param  stats: structure receiving the counters, zeroed when the
+  *         recovery is compiled out
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_GetRecoveryStats(ES_WIFI_RecoveryStats_t *stats)
+{
+  if (stats == NULL) {
+    return;
+  }
+#if ES_WIFI_RECOVERY
+  *stats = Recovery.Stats;
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+/**
+  * @brief  Reset the counters of the recovery of the module
+  * @param  None
+  * @retval None
+  */
+void IsmDrvClass::ES_WIFI_ResetRecoveryStats()
+{
+#if ES_WIFI_RECOVERY
+  memset(&Recovery.Stats, 0, sizeof(Recovery.Stats));
+#endif
+}
+
+/**
+  * @brief  Copy the last AT transactions of the journal
+  * @param  entries: array receiving the transactions, oldest first
+  * @param  max: size of the array
+  * @retval number of transactions copied
+  */
+uint16_t IsmDrvClass::ES_WIFI_GetJournal(ES_WIFI_JournalEntry_t *entries, uint16_t max)
+{
+#if ES_WIFI_JOURNAL_SIZE
+  uint32_t count = (journalCount < ES_WIFI_JOURNAL_SIZE) ? journalCount : ES_WIFI_JOURNAL_SIZE;
+
+  if (count > max) {
+    count = max;
+  }
+  return ES_WIFI_ReadJournal(journalCount - count, entries, count);
+#else
+  UNUSED(entries);
+  UNUSED(max);
+  return 0;
+#endif
+}
+
+/**
+  * @brief  Get the number of AT transactions recorded since the reset of the
+  *         journal, which is the index of the next one
+  * @retval number of transactions recorded
+  */
+uint32_t IsmDrvClass::ES_WIFI_GetJournalCount()
+{
+#if ES_WIFI_JOURNAL_SIZE
+  return journalCount;
+#else
+  return 0;
+#endif
+}
+
+/**
+  * @brief  Copy AT transactions of the journal from a given one, oldest first
+  * @param  index: index of the first transaction to copy, which must still be
+  *         kept: from ES_WIFI_GetJournalCount() - ES_WIFI_JOURNAL_SIZE
+  * @param  entries: array receiving the transactions
+  * @param  max: size of the array
+  * @retval number of transactions copied, 0 if index is not kept
+  */
+uint16_t IsmDrvClass::ES_WIFI_ReadJournal(uint32_t index, ES_WIFI_JournalEntry_t *entries, uint16_t max)
+{
+#if ES_WIFI_JOURNAL_SIZE
+  /* Unsigned, so that it also works once journalCount has wrapped */
+  uint32_t count = journalCount - index;
+
+  if ((entries == NULL) || (count > ES_WIFI_JOURNAL_SIZE)) {
+    return 0;
+  }
+  if (count > max) {
+    count = max;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    entries[i] = Journal[(index + i) & (ES_WIFI_JOURNAL_SIZE - 1)];
+  }
+  return count;
+#else
+  UNUSED(index);
+  UNUSED(entries);
+  UNUSED(max);
+  return 0;
+#endif
+}
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
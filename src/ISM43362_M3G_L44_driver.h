@@ -53,6 +53,9 @@
 #include <string.h>
 #include <stdio.h>
 #include "spi_drv.h"
+#include "uart_drv.h"
+#include "at_command.h"
+#include "at_framer.h"
 #include "wifi_drv.h"
 #include "wl_definitions.h"
 
@@ -304,34 +307,156 @@ typedef struct {
   uint32_t           BufferSize;
 } ES_WIFIObject_t;
 
+/* Copy of the socket settings of the module, to skip the commands which
+   would not change them                                                     */
+#define ES_WIFI_PARAM_UNKNOWN           0xFFFFFFFFUL
+
+typedef struct {
+  uint32_t Socket;                      /*!< current socket (P0)            */
+  uint32_t WriteTimeout;                /*!< write timeout in ms (S2)       */
+  uint32_t WritePacketSize;             /*!< write packet size (S1)         */
+  uint32_t ReadPacketSize;              /*!< read packet size (R1)          */
+  uint32_t ReadTimeout;                 /*!< read timeout in ms (R2)        */
+} ES_WIFI_Params_t;
+
+/* Timeout of a class of commands. When adaptive, the timeout follows the
+   smoothed latency and its variation, as the TCP retransmission timeout     */
+typedef struct {
+  uint32_t Max;                         /*!< configured timeout in ms       */
+  uint32_t Current;                     /*!< timeout in use in ms           */
+  uint32_t Srtt;                        /*!< smoothed latency in us, 0 until
+                                             measured                       */
+  uint32_t RttVar;                      /*!< latency variation in us        */
+  bool Adaptive;                        /*!< follow the observed latency    */
+} ES_WIFI_Timeout_t;
+
+/* State of the recovery of the module, with the network to join again */
+typedef struct {
+  bool Enabled;                         /*!< recover the module when it stops
+                                             answering                      */
+  bool Pending;                         /*!< recovery requested, run at the
+                                             start of the next operation    */
+  bool Running;                         /*!< recovery in progress           */
+  uint8_t Failures;                     /*!< exchanges in a row without
+                                             answer                         */
+  uint8_t ClientSockets;                /*!< client sockets connected, bit i
+                                             for socket i: dropped when the
+                                             connections are lost           */
+  uint32_t Backoff;                     /*!< delay before the next attempt
+                                             in ms, 0 after a success       */
+  uint32_t Last;                        /*!< millis() of the last failure   */
+  char SSID[ES_WIFI_MAX_SSID_NAME_SIZE + 1]; /*!< network joined, empty if
+                                             none                           */
+  char Pswd[ES_WIFI_MAX_PSWD_NAME_SIZE + 1]; /*!< passphrase of the network  */
+  ES_WIFI_SecurityType_t Security;      /*!< security of the network        */
+  ES_WIFI_RecoveryStats_t Stats;        /*!< counters                       */
+} ES_WIFI_Recovery_t;
+
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+/* Data read ahead from a socket, returned before reading the module again */
+typedef struct {
+  uint8_t Data[ES_WIFI_SOCKET_RX_BUFFER_SIZE]; /*!< data read              */
+  uint16_t Pos;                         /*!< next byte to return            */
+  uint16_t Len;                         /*!< bytes in Data                  */
+} ES_WIFI_RxBuffer_t;
+#endif
+
+#if ES_WIFI_SOCKET_TX_BUFFER_SIZE > 0
+/* Small writes to a socket, sent together */
+typedef struct {
+  uint8_t Data[ES_WIFI_SOCKET_TX_BUFFER_SIZE]; /*!< data to send           */
+  uint16_t Len;                         /*!< bytes in Data                  */
+  uint32_t Start;                       /*!< millis() of the first byte     */
+  uint32_t Timeout;                     /*!< timeout of the last write      */
+} ES_WIFI_TxBuffer_t;
+#endif
+
+/* Field of an answer, parsed in place: it is neither copied nor terminated */
+typedef struct {
+  char *Ptr;                            /*!< first character of the field   */
+  uint16_t Len;                         /*!< number of characters           */
+} AT_Span_t;
+
+typedef struct {
+  char *Pos;                            /*!< start of the next field, NULL
+                                             when all fields were returned  */
+  char *End;                            /*!< end of the answer              */
+  bool Delimited;                       /*!< last field ended by a delimiter */
+} AT_Fields_t;
+
 class IsmDrvClass : public WiFiDrvClass {
 
   private :
     DriverClass *Drv;                             // pointer on means of communication
+    comm_mode commMode;                           // means of communication
     ES_WIFIObject_t EsWifiObj;                    // settings pointer
+    ES_WIFI_Params_t Params;                      // socket settings of the module
+    ES_WIFI_Timeout_t Timeouts[ES_WIFI_CMD_CLASSES]; // timeout of each class of commands
+    bool lateAnswer;                              // an adaptive timeout expired
+    uint32_t lateEnd;                             // millis() when its answer is due
+#if ES_WIFI_JOURNAL_SIZE
+    ES_WIFI_JournalEntry_t Journal[ES_WIFI_JOURNAL_SIZE]; // last AT transactions
+    uint32_t journalCount;                        // transactions recorded
+#endif
+#if ES_WIFI_LATENCY_STATS
+    ES_WIFI_Latency_t Latency[ES_WIFI_LATENCY_CMDS]; // latency histogram of each command
+#endif
+#if ES_WIFI_RECOVERY
+    ES_WIFI_Recovery_t Recovery;                  // recovery of the module
+#endif
+#if ES_WIFI_SOCKET_RX_BUFFER_SIZE > 0
+    ES_WIFI_RxBuffer_t RxBuffer[MAX_SOCK_NUM];    // data read ahead from each socket
+#endif
+#if ES_WIFI_SOCKET_TX_BUFFER_SIZE > 0
+    ES_WIFI_TxBuffer_t TxBuffer[MAX_SOCK_NUM];    // small writes to each socket
+#endif
+    AtCommandClass Cmd;                           // command being built in CmdData
+    AtFramerClass Framer;                         // status of the answers
     ES_WIFI_SystemConfig_t ESWifiSysObj;          // configuration pointer
     ES_WIFI_APs_t ESWifiApObj;                    // list of network
     ES_WIFI_Conn_t ESWifiConnTab[MAX_SOCK_NUM];   // local table to know which socket are use
     uint8_t currentSock;                          // the current socket
     socket_status_t sockState[MAX_SOCK_NUM];      // socket status
+    bool warmStart;                               // try to skip the reset at init
+    uint32_t bootTime;                            // duration of the last init (ms)
+    bool writeWithLength;                         // firmware supports S3
 
     uint8_t Hex2Num(char a);
     uint32_t ParseHexNumber(char *ptr, uint8_t *cnt);
     int32_t ParseNumber(char *ptr, uint8_t *cnt);
     void ParseMAC(char *ptr, uint8_t *arr);
     void ParseIP(char *ptr, uint8_t *arr);
-    ES_WIFI_SecurityType_t ParseSecurity(char *ptr);
+    ES_WIFI_SecurityType_t ParseSecurity(const AT_Span_t *field);
+    uint32_t AT_ParseFWRev(char *ptr);
+    void AT_FieldsInit(AT_Fields_t *fields, char *pdata, uint16_t len);
+    bool AT_NextField(AT_Fields_t *fields, char delim, AT_Span_t *field);
+    void AT_CopyField(uint8_t *dest, uint16_t size, const AT_Span_t *field);
     void AT_ParseInfo(uint8_t *pdata);
-    bool AT_ParseSingleAP(char *pdata, ES_WIFI_AP_t *AP);
+    bool AT_ParseSingleAP(const AT_Span_t *line, ES_WIFI_AP_t *AP);
     void AT_ParseSystemConfig(char *pdata, ES_WIFI_SystemConfig_t *pConfig);
     void AT_ParseConnSettings(char *pdata, ES_WIFI_Network_t *NetSettings);
     void AT_ParseTrSettings(char *pdata, ES_WIFI_Conn_t *ConnSettings);
-    ES_WIFI_Status_t AT_ExecuteCommand(void);
+    ES_WIFI_Status_t AT_ExecuteCommand(ES_WIFI_CmdClass_t cmdClass = ES_WIFI_CMD_CONFIG);
+    void AT_InitTimeouts(void);
+    void AT_ResetTimeouts(void);
+    void AT_UpdateTimeout(ES_WIFI_CmdClass_t cmdClass, ES_WIFI_Status_t status, uint32_t elapsed);
+    void AT_DrainLateAnswer(void);
+    void AT_Record(const char *code, uint16_t len, ES_WIFI_Status_t status, uint32_t start);
+    void AT_AddLatency(const char *code, uint32_t elapsed);
+    void AT_CheckLink(ES_WIFI_Status_t status);
+    void AT_Recover(void);
+    void AT_InvalidateParams(void);
+    ES_WIFI_Status_t AT_SetParam(const char (&cmd)[3], uint32_t value, uint32_t *param);
+    ES_WIFI_Status_t AT_SelectSocket(uint8_t socket);
     ES_WIFI_Status_t AT_ReceiveCommand(uint8_t *pdata, uint16_t Reqlen);
-    ES_WIFI_Status_t AT_RequestSendData(uint8_t *cmd, uint16_t len, uint8_t *pdata);
+    ES_WIFI_Status_t AT_RequestSendData(uint8_t *cmd, uint16_t cmdlen, uint8_t *pdata, uint16_t len);
     ES_WIFI_Status_t ReceiveShortDataLen(char *pdata, uint16_t Reqlen, uint16_t *ReadData);
     ES_WIFI_Status_t ReceiveLongDataLen(char *pdata, uint16_t Reqlen, uint16_t *ReadData);
-    ES_WIFI_Status_t AT_RequestReceiveData(uint8_t *cmd, char *pdata, uint16_t Reqlen, uint16_t *ReadData);
+    ES_WIFI_Status_t AT_RequestReceiveData(uint8_t *cmd, uint16_t cmdlen, char *pdata, uint16_t Reqlen, uint16_t *ReadData);
+    void AT_ReceiveSocketData(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *Receivedlen, uint32_t Timeout);
+    void AT_FillRxBuffer(uint8_t Socket, uint32_t Timeout);
+    void AT_ClearBuffers(uint8_t socket);
+    ES_WIFI_Status_t AT_SetUARTBaudRate(uint32_t BaudRate);
     ES_WIFI_Status_t ES_WIFI_SetTimeout(uint32_t Timeout);
     ES_WIFI_Status_t ES_WIFI_GetNetworkSettings();
     ES_WIFI_Status_t ES_WIFI_GetSystemConfig();
@@ -377,13 +502,34 @@ class IsmDrvClass : public WiFiDrvClass {
     virtual void ES_WIFI_StopServerSingleConn(uint8_t index);
     virtual void ES_WIFI_StartServerMultiConn(uint8_t socket, comm_mode mode);
     virtual void ES_WIFI_StopServerMultiConn();
-    virtual void ES_WIFI_ReceiveData(uint8_t Socket, uint8_t *pdata, uint16_t Reqlen, uint16_t *Receivedlen, uint32_t Timeout);
+    virtual void ES_WIFI_ReceiveData(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *Receivedlen, uint32_t Timeout);
+    virtual int ES_WIFI_Available(uint8_t Socket);
+    virtual int ES_WIFI_Peek(uint8_t Socket);
     virtual void ES_WIFI_getRemoteData(uint8_t sock, uint8_t *ip, uint16_t *port);
     virtual bool ES_WIFI_SetConnectionParam(uint8_t Number, ES_WIFI_ConnType_t Type, uint16_t LocalPort, IPAddress Ip = INADDR_NONE);
-    virtual void ES_WIFI_SendResp(uint8_t Socket, uint8_t *pdata, uint16_t Reqlen, uint16_t *SentLen, uint32_t Timeout);
+    virtual void ES_WIFI_SendResp(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *SentLen, uint32_t Timeout);
+    virtual void ES_WIFI_Write(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *SentLen, uint32_t Timeout);
+    virtual bool ES_WIFI_Flush(uint8_t Socket, bool expired);
     virtual uint8_t getCurrentSocket(void);
     virtual int8_t getFreeSocket(void);
     virtual uint8_t getSocketState(uint8_t socket);
+    virtual void ES_WIFI_GetIOStats(IO_Stats_t *stats);
+    virtual void ES_WIFI_ResetIOStats();
+    virtual void ES_WIFI_SetCSTiming(uint16_t setup_us, uint16_t hold_us);
+    virtual void ES_WIFI_SetIOSpeed(uint32_t speed);
+    virtual uint32_t ES_WIFI_GetIOSpeed();
+    virtual void ES_WIFI_SetWarmStart(bool enable);
+    virtual uint32_t ES_WIFI_GetBootTime();
+    virtual void ES_WIFI_SetCmdTimeout(ES_WIFI_CmdClass_t cmdClass, uint32_t timeout, bool adaptive);
+    virtual uint32_t ES_WIFI_GetCmdTimeout(ES_WIFI_CmdClass_t cmdClass);
+    virtual uint16_t ES_WIFI_GetJournal(ES_WIFI_JournalEntry_t *entries, uint16_t max);
+    virtual uint32_t ES_WIFI_GetJournalCount();
+    virtual uint16_t ES_WIFI_ReadJournal(uint32_t index, ES_WIFI_JournalEntry_t *entries, uint16_t max);
+    virtual bool ES_WIFI_GetLatency(uint8_t index, ES_WIFI_Latency_t *hist);
+    virtual void ES_WIFI_ResetLatency();
+    virtual void ES_WIFI_SetRecovery(bool enable);
+    virtual void ES_WIFI_GetRecoveryStats(ES_WIFI_RecoveryStats_t *stats);
+    virtual void ES_WIFI_ResetRecoveryStats();
 };
 
 #endif /*__ES_WIFI_H*/
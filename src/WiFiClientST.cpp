@@ -96,16 +96,17 @@ int WiFiClient::connect(const char *host, uint16_t port)
 
 /**
  * @brief  Write size bytes from buffer into the packet
+ *         Small writes are gathered and sent together, see flush().
  * @param  buf : data to write
  * @param  size : size of data to write
  * @retval size of write data
  */
 size_t WiFiClient::write(const uint8_t *buf, size_t size)
 {
-  uint16_t SentLen = 0; // number of data really send
+  size_t SentLen = 0; // number of data really send
   uint8_t *temp = (uint8_t *)buf;
 
-  DrvWiFi->ES_WIFI_SendResp(_sock, temp, size, &SentLen, WIFI_TIMEOUT);
+  DrvWiFi->ES_WIFI_Write(_sock, temp, size, &SentLen, WIFI_TIMEOUT);
   return SentLen;
 }
 
@@ -122,29 +123,28 @@ size_t WiFiClient::write(uint8_t b)
 /**
  * @brief  Return number of bytes available in the current packet
  * @param  None
- * @retval number of bytes available in the current packet
- * @Note Function not supported , always return 1.
+ * @retval number of bytes which can be read without waiting. When none are
+ *         buffered, the module is polled with a short timeout.
  */
 int WiFiClient::available()
 {
-  /***************************************************************************/
-  /*                               NOT SUPPORTED                             */
-  /* This functionality doesn't exist in the current device.                 */
-  /***************************************************************************/
-  return 1;
+  if (_sock == NO_SOCKET_AVAIL) {
+    return 0;
+  }
+  return DrvWiFi->ES_WIFI_Available(_sock);
 }
 
 /**
  * @brief  Read a single byte from the current packet
  * @param  None
- * @retval the read byte
+ * @retval the read byte, -1 if none was received
  */
 int WiFiClient::read()
 {
   uint8_t b = '\0'; // data received
-  uint16_t RecLen = 0; // number of data received
+  size_t RecLen = 0; // number of data received
   DrvWiFi->ES_WIFI_ReceiveData(_sock, &b, 1, &RecLen, WIFI_TIMEOUT);
-  return b;
+  return (RecLen == 1) ? b : -1;
 }
 
 /**
@@ -155,7 +155,7 @@ int WiFiClient::read()
  */
 int WiFiClient::read(uint8_t *buf, size_t size)
 {
-  uint16_t RecLen = 0; // number of data received
+  size_t RecLen = 0; // number of data received
 
   DrvWiFi->ES_WIFI_ReceiveData(_sock, buf, size, &RecLen, WIFI_TIMEOUT);
   if (RecLen < size) {
@@ -167,34 +167,35 @@ int WiFiClient::read(uint8_t *buf, size_t size)
 /**
  * @brief  Return the next byte from the current packet without moving on to the next byte
  * @param  None
- * @retval next byte from the current packet without moving on to the next byte
- * @Note Function not supported , always return 0.
+ * @retval next byte from the current packet, -1 if none is available
  */
 int WiFiClient::peek()
 {
-  /***************************************************************************/
-  /*                               NOT SUPPORTED                             */
-  /* This functionality doesn't exist in the current device.                 */
-  /***************************************************************************/
-  return 0;
+  if (_sock == NO_SOCKET_AVAIL) {
+    return -1;
+  }
+  return DrvWiFi->ES_WIFI_Peek(_sock);
 }
 
 /**
- * @brief  Finish reading the current packet
+ * @brief  Send the data gathered by write(). If they cannot all be sent,
+ *         the write error is set, see getWriteError().
  * @param  None
  * @retval None
- * @Note Function not supported
  */
 void WiFiClient::flush()
 {
-  /***************************************************************************/
-  /*                               NOT SUPPORTED                             */
-  /* Not supported in previous device, still not supported                   */
-  /***************************************************************************/
+  if (_sock == NO_SOCKET_AVAIL) {
+    return;
+  }
+  if (!DrvWiFi->ES_WIFI_Flush(_sock, false)) {
+    setWriteError();
+  }
 }
 
 /**
- * @brief  Close the client connection
+ * @brief  Close the client connection. The data gathered by write() which
+ *         cannot be sent are dropped and the write error is set.
  * @param  None
  * @retval None
  */
@@ -203,6 +204,9 @@ void WiFiClient::stop()
   if (_sock == NO_SOCKET_AVAIL) {
     return;
   }
+  if (!DrvWiFi->ES_WIFI_Flush(_sock, false)) {
+    setWriteError();
+  }
   DrvWiFi->ES_WIFI_StopServerSingleConn(_sock);
   _sock = NO_SOCKET_AVAIL;
 }
@@ -217,6 +221,10 @@ uint8_t WiFiClient::connected()
   if (_sock == 255) {
     return 0;
   } else {
+    /* Send the data gathered for too long */
+    if (!DrvWiFi->ES_WIFI_Flush(_sock, true)) {
+      setWriteError();
+    }
     return status();
   }
 }
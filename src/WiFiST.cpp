@@ -360,6 +360,269 @@ int WiFiClass::hostByName(const char *aHostname, IPAddress aResult)
   return 1;
 }
 
+/*
+* @brief  Set the SPI chip select setup and hold times.
+* @param  setupUs: delay between select and the first clock, in us
+* @param  holdUs: delay after deselect, in us
+* @retval None
+*/
+void WiFiClass::setCSTiming(uint16_t setupUs, uint16_t holdUs)
+{
+  DrvWiFi->ES_WIFI_SetCSTiming(setupUs, holdUs);
+}
+
+/*
+* @brief  Set the fastest SPI clock tried when the WiFi device is initialized.
+*         Slower clocks are tried if the device answer is corrupted.
+*         Must be called before the first call to status() or begin().
+*         With an UART, set the baud rate: before init, the one the device
+*         currently uses, after init, the device is switched to it.
+* @param  speed: clock in Hz (default SPI_CLOCK_MAX or UART_BAUDRATE). An SPI
+*                clock below SPI_CLOCK_MIN is raised to it.
+* @retval None
+*/
+void WiFiClass::setBusSpeed(uint32_t speed)
+{
+  DrvWiFi->ES_WIFI_SetIOSpeed(speed);
+}
+
+/*
+* @brief  Get the SPI clock chosen when the WiFi device was initialized, or
+*         the UART baud rate.
+* @param  None
+* @retval clock in Hz, 0 if the device is not initialized
+*/
+uint32_t WiFiClass::busSpeed()
+{
+  return DrvWiFi->ES_WIFI_GetIOSpeed();
+}
+
+/*
+* @brief  Get the statistics of the exchanges with the WiFi device: number of
+*         command/response exchanges, bytes sent and received, timeouts, time
+*         spent in them split between waiting for the device, clocking the
+*         bytes and deliberate delays, and the longest wait.
+*         All counters stay at 0 if IO_STATS is set to 0.
+* @param  stats: where to copy the counters
+* @retval None
+*/
+void WiFiClass::getIOStats(IO_Stats_t *stats)
+{
+  DrvWiFi->ES_WIFI_GetIOStats(stats);
+}
+
+/*
+* @brief  Reset the statistics of the exchanges with the WiFi device.
+* @param  None
+* @retval None
+*/
+void WiFiClass::resetIOStats()
+{
+  DrvWiFi->ES_WIFI_ResetIOStats();
+}
+
+/*
+* @brief  Use the WiFi device without resetting it at init if it is already
+*         running and answers. Must be called before the first call to
+*         status() or begin().
+* @param  enable: true to try a warm start (default ES_WIFI_WARM_START)
+* @retval None
+*/
+void WiFiClass::setWarmStart(bool enable)
+{
+  DrvWiFi->ES_WIFI_SetWarmStart(enable);
+}
+
+/*
+* @brief  Get the time taken to get the WiFi device ready at init.
+* @param  None
+* @retval time in ms, 0 if the device is not initialized
+*/
+uint32_t WiFiClass::bootTime()
+{
+  return DrvWiFi->ES_WIFI_GetBootTime();
+}
+
+/*
+* @brief  Set the timeout of a class of commands of the WiFi device.
+* @param  cmdClass: ES_WIFI_CMD_CONFIG, ES_WIFI_CMD_JOIN, ES_WIFI_CMD_SCAN,
+*         ES_WIFI_CMD_DNS or ES_WIFI_CMD_SLOW. The socket data use the
+*         timeout of the socket.
+* @param  timeout: timeout in ms
+* @param  adaptive: true to shorten the timeout to the observed latency of
+*         the device, so that a device which does not answer is detected
+*         sooner. When it expires, the timeout is doubled; the late answer is
+*         drained before the next command, waiting for it up to timeout
+* @retval None
+*/
+void WiFiClass::setCommandTimeout(ES_WIFI_CmdClass_t cmdClass, uint32_t timeout, bool adaptive)
+{
+  DrvWiFi->ES_WIFI_SetCmdTimeout(cmdClass, timeout, adaptive);
+}
+
+/*
+* @brief  Get the timeout in use for a class of commands.
+* @param  cmdClass: class of commands
+* @retval timeout in ms
+*/
+uint32_t WiFiClass::commandTimeout(ES_WIFI_CmdClass_t cmdClass)
+{
+  return DrvWiFi->ES_WIFI_GetCmdTimeout(cmdClass);
+}
+
+/*
+* @brief  Get the last AT transactions with the WiFi device.
+* @param  entries: array receiving the transactions, oldest first
+* @param  max: size of the array, up to ES_WIFI_JOURNAL_SIZE are kept
+* @retval number of transactions copied
+*/
+uint16_t WiFiClass::getJournal(ES_WIFI_JournalEntry_t *entries, uint16_t max)
+{
+  return DrvWiFi->ES_WIFI_GetJournal(entries, max);
+}
+
+/*
+* @brief  Print the last AT transactions with the WiFi device, oldest first:
+*         start time (us), duration (us), command, socket, payload length
+*         and status (0 when successful).
+* @param  out: where to print, such as Serial
+* @retval None
+*/
+void WiFiClass::printJournal(Print &out)
+{
+  /* Read in small batches, as the journal may not fit on the stack */
+  ES_WIFI_JournalEntry_t entries[8];
+  uint32_t end = DrvWiFi->ES_WIFI_GetJournalCount();
+  uint32_t index = (end > ES_WIFI_JOURNAL_SIZE) ? (end - ES_WIFI_JOURNAL_SIZE) : 0;
+  uint32_t left;
+  uint16_t count;
+
+  while (index != end) {
+    left = end - index;
+    count = DrvWiFi->ES_WIFI_ReadJournal(index, entries, (left < 8) ? left : 8);
+    if (count == 0) {
+      /* Overwritten while printing */
+      break;
+    }
+    index += count;
+    for (uint16_t i = 0; i < count; i++) {
+      out.print(entries[i].Start);
+      out.print(' ');
+      out.print(entries[i].End - entries[i].Start);
+      out.print(' ');
+      out.print(entries[i].Cmd[0]);
+      out.print(entries[i].Cmd[1]);
+      out.print(' ');
+      out.print(entries[i].Socket);
+      out.print(' ');
+      out.print(entries[i].Len);
+      out.print(' ');
+      out.println(entries[i].Status);
+    }
+  }
+}
+
+/*
+* @brief  Get the latency histogram of an AT command, to list them all.
+* @param  index: index of the command, from 0 to ES_WIFI_LATENCY_CMDS - 1
+* @param  hist: copy of the histogram: command code and counts, bucket i
+*         counts the latencies from 2^i to 2^(i+1) us
+* @retval false if no command has this index
+*/
+bool WiFiClass::getLatency(uint8_t index, ES_WIFI_Latency_t *hist)
+{
+  return DrvWiFi->ES_WIFI_GetLatency(index, hist);
+}
+
+/*
+* @brief  Get the latency histogram of an AT command.
+* @param  cmd: command code, such as "P0"
+* @param  hist: copy of the histogram
+* @retval false if the command was not seen
+*/
+bool WiFiClass::getLatency(const char *cmd, ES_WIFI_Latency_t *hist)
+{
+  for (uint8_t i = 0; DrvWiFi->ES_WIFI_GetLatency(i, hist); i++) {
+    if ((hist->Cmd[0] == cmd[0]) && (hist->Cmd[1] == cmd[1])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+* @brief  Get a percentile of the latency of an AT command.
+* @param  cmd: command code, such as "P0"
+* @param  percent: percentile, such as 50 or 99
+* @retval upper bound of the bucket holding the percentile in us, 0 if the
+*         command was not seen. The last bucket also holds all the longer
+*         latencies: UINT32_MAX when the percentile falls in it.
+*/
+uint32_t WiFiClass::latencyPercentile(const char *cmd, uint8_t percent)
+{
+  ES_WIFI_Latency_t hist;
+  uint64_t total = 0;
+  uint64_t sum = 0;
+
+  if (!getLatency(cmd, &hist)) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < ES_WIFI_LATENCY_BUCKETS; i++) {
+    total += hist.Count[i];
+  }
+  for (uint8_t i = 0; i < ES_WIFI_LATENCY_BUCKETS; i++) {
+    sum += hist.Count[i];
+    if ((sum > 0) && (sum * 100 >= total * percent)) {
+      /* The last bucket has no upper bound */
+      return (i == ES_WIFI_LATENCY_BUCKETS - 1) ? UINT32_MAX : (1UL << (i + 1));
+    }
+  }
+  return 0;
+}
+
+/*
+* @brief  Clear the latency histograms of the AT commands.
+* @param  None
+* @retval None
+*/
+void WiFiClass::resetLatency()
+{
+  DrvWiFi->ES_WIFI_ResetLatency();
+}
+
+/*
+* @brief  Enable or disable the recovery of the Wifi module when it stops
+*         answering: the link is resynchronized or the module reset, then
+*         the network is joined again. The client sockets whose connection
+*         is lost are closed: connected() returns false.
+* @param  enable: true to recover the module (default)
+* @retval None
+*/
+void WiFiClass::setRecovery(bool enable)
+{
+  DrvWiFi->ES_WIFI_SetRecovery(enable);
+}
+
+/*
+* @brief  Get the counters of the recovery of the Wifi module.
+* @param  stats: structure receiving the counters
+* @retval None
+*/
+void WiFiClass::getRecoveryStats(ES_WIFI_RecoveryStats_t *stats)
+{
+  DrvWiFi->ES_WIFI_GetRecoveryStats(stats);
+}
+
+/*
+* @brief  Clear the counters of the recovery of the Wifi module.
+* @param  None
+* @retval None
+*/
+void WiFiClass::resetRecoveryStats()
+{
+  DrvWiFi->ES_WIFI_ResetRecoveryStats();
+}
+
 WiFiDrvClass *DrvWiFi;
 
 /******************* (C) COPYRIGHT 2017 Wi6labs ***********END OF FILE********/
@@ -76,6 +76,24 @@ class WiFiClass {
     int8_t scanNetworks();
     static uint8_t getSocket();
     int hostByName(const char *aHostname, IPAddress aResult);
+    void setCSTiming(uint16_t setupUs, uint16_t holdUs);
+    void setBusSpeed(uint32_t speed);
+    uint32_t busSpeed();
+    void getIOStats(IO_Stats_t *stats);
+    void resetIOStats();
+    void setWarmStart(bool enable);
+    uint32_t bootTime();
+    void setCommandTimeout(ES_WIFI_CmdClass_t cmdClass, uint32_t timeout, bool adaptive = false);
+    uint32_t commandTimeout(ES_WIFI_CmdClass_t cmdClass);
+    uint16_t getJournal(ES_WIFI_JournalEntry_t *entries, uint16_t max);
+    void printJournal(Print &out);
+    bool getLatency(uint8_t index, ES_WIFI_Latency_t *hist);
+    bool getLatency(const char *cmd, ES_WIFI_Latency_t *hist);
+    uint32_t latencyPercentile(const char *cmd, uint8_t percent);
+    void resetLatency();
+    void setRecovery(bool enable);
+    void getRecoveryStats(ES_WIFI_RecoveryStats_t *stats);
+    void resetRecoveryStats();
 };
 
 extern WiFiDrvClass *DrvWiFi;
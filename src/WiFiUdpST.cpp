@@ -147,7 +147,7 @@ int WiFiUDP::endPacket(bool stop)
  */
 size_t WiFiUDP::write(const uint8_t *buffer, size_t size)
 {
-  uint16_t SentLen = 0; // number of data really send
+  size_t SentLen = 0; // number of data really send
   uint8_t *temp = (uint8_t *)buffer;
 
   DrvWiFi->ES_WIFI_SendResp(_sock, temp, size, &SentLen, WIFI_TIMEOUT);
@@ -193,15 +193,15 @@ int WiFiUDP::parsePacket()
 /**
  * @brief  Read a single byte from the current packet
  * @param  None
- * @retval the read byte
+ * @retval the read byte, -1 if none was received
  */
 int WiFiUDP::read()
 {
   uint8_t b = 0; // data received
-  uint16_t RecLen = 0; // Number of data received
+  size_t RecLen = 0; // Number of data received
 
   DrvWiFi->ES_WIFI_ReceiveData(_sock, &b, 1, &RecLen, WIFI_TIMEOUT);
-  return b;
+  return (RecLen == 1) ? b : -1;
 }
 
 /**
@@ -212,7 +212,7 @@ int WiFiUDP::read()
  */
 int WiFiUDP::read(unsigned char *buffer, size_t len)
 {
-  uint16_t RecLen = 0; // Number of data received
+  size_t RecLen = 0; // Number of data received
 
   DrvWiFi->ES_WIFI_ReceiveData(_sock, buffer, len, &RecLen, WIFI_TIMEOUT);
   if (RecLen < len) {
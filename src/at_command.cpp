@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    at_command.cpp
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file implements the encoder of the AT commands of the
+  *          es-wifi module. Numbers and addresses are converted in place,
+  *          without the printf machinery.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2017 STMicroelectronics International N.V.
+  * All rights reserved.</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted, provided that the following conditions are met:
+  *
+  * 1. Redistribution of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  * 3. Neither the name of STMicroelectronics nor the names of other
+  *    contributors to this software may be used to endorse or promote products
+  *    derived from this software without specific written permission.
+  * 4. This software, including modifications and/or derivative works of this
+  *    software, must execute solely and exclusively on microcontroller or
+  *    microprocessor devices manufactured by or for STMicroelectronics.
+  * 5. Redistribution and use of this software other than as permitted under
+  *    this license is void and will automatically terminate your rights under
+  *    this license.
+  *
+  * THIS SOFTWARE IS PROVIDED BY STMICROELECTRONICS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS, IMPLIED OR STATUTORY WARRANTIES, INCLUDING, BUT NOT
+  * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+  * PARTICULAR PURPOSE AND NON-INFRINGEMENT OF THIRD PARTY INTELLECTUAL PROPERTY
+  * RIGHTS ARE DISCLAIMED TO THE FULLEST EXTENT PERMITTED BY LAW. IN NO EVENT
+  * SHALL STMICROELECTRONICS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+  * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#include "at_command.h"
+
+/**
+ * @brief  Constructor.
+ * @param  None
+ * @retval None
+ */
+AtCommandClass::AtCommandClass()
+{
+  buffer = NULL;
+  size = 0;
+  length = 0;
+  overflow = false;
+}
+
+/**
+ * @brief  Set the buffer where the commands are built.
+ * @param  buf: transmit buffer
+ * @param  bufSize: size of the buffer
+ * @retval None
+ */
+void AtCommandClass::Init(uint8_t *buf, uint16_t bufSize)
+{
+  buffer = buf;
+  size = bufSize;
+  length = 0;
+  overflow = false;
+}
+
+/**
+ * @brief  Append bytes. Once a command does not fit, nothing is appended
+ *         anymore and Overflow() returns true.
+ * @param  data: bytes to append
+ * @param  len: number of bytes
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Bytes(const char *data, uint16_t len)
+{
+  if (overflow || (len > size - length)) {
+    overflow = true;
+  } else {
+    memcpy(buffer + length, data, len);
+    length += len;
+  }
+  return *this;
+}
+
+/**
+ * @brief  Append a string only known at run time.
+ * @param  str: NUL terminated string
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Str(const char *str)
+{
+  return Bytes(str, strlen(str));
+}
+
+/**
+ * @brief  Append a character.
+ * @param  c: character
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Char(char c)
+{
+  return Bytes(&c, 1);
+}
+
+/**
+ * @brief  Append an unsigned decimal number.
+ * @param  value: number
+ * @param  width: minimum number of digits, padded with zeros
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Uint(uint32_t value, uint8_t width)
+{
+  char digits[10];
+  uint8_t n = 0;
+
+  /* Digits are produced from the lowest one */
+  do {
+    digits[sizeof(digits) - 1 - n] = '0' + (value % 10);
+    value /= 10;
+    n++;
+  } while ((value != 0) || ((n < width) && (n < sizeof(digits))));
+  return Bytes(digits + sizeof(digits) - n, n);
+}
+
+/**
+ * @brief  Append a signed decimal number.
+ * @param  value: number
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Int(int32_t value)
+{
+  if (value < 0) {
+    Char('-');
+    return Uint(0 - (uint32_t)value);
+  }
+  return Uint(value);
+}
+
+/**
+ * @brief  Append an hexadecimal number in upper case, without leading zeros.
+ * @param  value: number
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Hex(uint32_t value)
+{
+  char digits[8];
+  uint8_t n = 0;
+
+  do {
+    digits[sizeof(digits) - 1 - n] = "0123456789ABCDEF"[value & 0xF];
+    value >>= 4;
+    n++;
+  } while (value != 0);
+  return Bytes(digits + sizeof(digits) - n, n);
+}
+
+/**
+ * @brief  Append an IPv4 address in dotted decimal.
+ * @param  ip: the 4 bytes of the address
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::Ip(const uint8_t *ip)
+{
+  for (uint8_t i = 0; i < 4; i++) {
+    if (i != 0) {
+      Char('.');
+    }
+    Uint(ip[i]);
+  }
+  return *this;
+}
+
+/**
+ * @brief  Terminate the command.
+ * @param  None
+ * @retval The encoder, to chain the calls.
+ */
+AtCommandClass &AtCommandClass::End(void)
+{
+  return Text(AT_COMMAND_SUFFIX);
+}
+
+/**
+ * @brief  Return the command.
+ * @param  None
+ * @retval Pointer to the transmit buffer.
+ */
+uint8_t *AtCommandClass::Data(void)
+{
+  return buffer;
+}
+
+/**
+ * @brief  Return the length of the command.
+ * @param  None
+ * @retval Number of bytes of the command, without any terminating NUL.
+ */
+uint16_t AtCommandClass::Length(void)
+{
+  return length;
+}
+
+/**
+ * @brief  Tell whether the command did not fit in the buffer.
+ * @param  None
+ * @retval true if some bytes were dropped.
+ */
+bool AtCommandClass::Overflow(void)
+{
+  return overflow;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
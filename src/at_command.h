@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file    at_command.h
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file contains the encoder which builds the AT commands of
+  *          the es_wifi module in place.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#ifndef AT_COMMAND_H
+#define AT_COMMAND_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+/* End of a command                                                          */
+#define AT_COMMAND_SUFFIX        "\r"
+
+/* Builds a command straight into the transmit buffer and keeps its length,
+   so that it is neither formatted with printf nor scanned with strlen. The
+   command codes and the constant texts are string literals: their length is
+   known at compile time.
+   Example: Cmd.Start(AT_TR_SET_SOCKET).Char('=').Uint(socket).End();       */
+class AtCommandClass {
+
+  private :
+    uint8_t *buffer;                      // transmit buffer
+    uint16_t size;                        // size of the buffer
+    uint16_t length;                      // length of the command
+    bool overflow;                        // the command did not fit
+
+  public:
+
+    AtCommandClass();
+
+    void Init(uint8_t *buf, uint16_t bufSize);
+
+    /* Start a command with its code, such as AT_SCAN                        */
+    template <size_t N>
+    AtCommandClass &Start(const char (&code)[N])
+    {
+      length = 0;
+      overflow = false;
+      return Bytes(code, N - 1);
+    }
+
+    /* Append a constant text                                                */
+    template <size_t N>
+    AtCommandClass &Text(const char (&text)[N])
+    {
+      return Bytes(text, N - 1);
+    }
+
+    AtCommandClass &Bytes(const char *data, uint16_t len);
+    AtCommandClass &Str(const char *str);
+    AtCommandClass &Char(char c);
+    AtCommandClass &Uint(uint32_t value, uint8_t width = 0);
+    AtCommandClass &Int(int32_t value);
+    AtCommandClass &Hex(uint32_t value);
+    AtCommandClass &Ip(const uint8_t *ip);
+    AtCommandClass &End(void);
+
+    uint8_t *Data(void);
+    uint16_t Length(void);
+    bool Overflow(void);
+};
+
+#endif // AT_COMMAND_H
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
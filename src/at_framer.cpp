@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    at_framer.cpp
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file implements the framer which finds the status of the
+  *          answers of the es-wifi module. The OK string is matched as a
+  *          suffix and the ERROR string at a line start, both with a
+  *          Knuth-Morris-Pratt automaton so that no byte is read twice.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2017 STMicroelectronics International N.V.
+  * All rights reserved.</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted, provided that the following conditions are met:
+  *
+  * 1. Redistribution of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  * 3. Neither the name of STMicroelectronics nor the names of other
+  *    contributors to this software may be used to endorse or promote products
+  *    derived from this software without specific written permission.
+  * 4. This software, including modifications and/or derivative works of this
+  *    software, must execute solely and exclusively on microcontroller or
+  *    microprocessor devices manufactured by or for STMicroelectronics.
+  * 5. Redistribution and use of this software other than as permitted under
+  *    this license is void and will automatically terminate your rights under
+  *    this license.
+  *
+  * THIS SOFTWARE IS PROVIDED BY STMICROELECTRONICS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS, IMPLIED OR STATUTORY WARRANTIES, INCLUDING, BUT NOT
+  * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+  * PARTICULAR PURPOSE AND NON-INFRINGEMENT OF THIRD PARTY INTELLECTUAL PROPERTY
+  * RIGHTS ARE DISCLAIMED TO THE FULLEST EXTENT PERMITTED BY LAW. IN NO EVENT
+  * SHALL STMICROELECTRONICS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+  * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "at_framer.h"
+
+/**
+ * @brief  Constructor.
+ * @param  None
+ * @retval None
+ */
+AtFramerClass::AtFramerClass()
+{
+  At_Framer_Build(AT_FRAMER_OK_STRING, AT_FRAMER_OK_LEN, okFail);
+  At_Framer_Build(AT_FRAMER_ERROR_STRING, AT_FRAMER_ERROR_LEN, errorFail);
+  Reset();
+}
+
+/**
+ * @brief  Build the fallback table of a matcher: for each number of bytes
+ *         matched, the length of the longest prefix of the pattern which is
+ *         also a suffix of the bytes matched.
+ * @param  pattern : string to match
+ * @param  len     : string length
+ * @param  fail    : table to build, len entries
+ * @retval None
+ */
+void AtFramerClass::At_Framer_Build(const char *pattern, uint8_t len, uint8_t *fail)
+{
+  uint8_t k = 0;
+
+  fail[0] = 0;
+  for (uint8_t i = 1; i < len; i++) {
+    while ((k > 0) && (pattern[i] != pattern[k])) {
+      k = fail[k - 1];
+    }
+    if (pattern[i] == pattern[k]) {
+      k++;
+    }
+    fail[i] = k;
+  }
+}
+
+/**
+ * @brief  Advance a matcher by one byte.
+ * @param  pattern : string to match
+ * @param  fail    : fallback table of the pattern
+ * @param  match   : bytes of the pattern matched before this byte
+ * @param  c       : byte received
+ * @retval bytes of the pattern matched after this byte.
+ */
+uint8_t AtFramerClass::At_Framer_Step(const char *pattern, const uint8_t *fail,
+                                      uint8_t match, uint8_t c)
+{
+  while ((match > 0) && ((uint8_t)pattern[match] != c)) {
+    match = fail[match - 1];
+  }
+  if ((uint8_t)pattern[match] == c) {
+    match++;
+  }
+  return match;
+}
+
+/**
+ * @brief  Forget the answer fed so far, to frame a new one.
+ * @param  None
+ * @retval None
+ */
+void AtFramerClass::Reset(void)
+{
+  okMatch = 0;
+  errorMatch = 0;
+  errorSeen = false;
+}
+
+/**
+ * @brief  Feed the next bytes of the answer.
+ * @param  data : bytes received
+ * @param  len  : number of bytes
+ * @retval Status of the answer fed so far.
+ */
+AT_FrameStatus_t AtFramerClass::Feed(const uint8_t *data, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    if ((okMatch == 0) && (errorSeen || (errorMatch == 0))) {
+      // Nothing matched: both strings start with '\r', skip to the next one
+      const uint8_t *cr = (const uint8_t *)memchr(data + i, '\r', len - i);
+      if (cr == NULL) {
+        break;
+      }
+      i = cr - data;
+    }
+    if (okMatch == AT_FRAMER_OK_LEN) {
+      // More bytes after the OK string: it was part of the data
+      okMatch = okFail[okMatch - 1];
+    }
+    okMatch = At_Framer_Step(AT_FRAMER_OK_STRING, okFail, okMatch, data[i]);
+
+    if (!errorSeen) {
+      errorMatch = At_Framer_Step(AT_FRAMER_ERROR_STRING, errorFail, errorMatch, data[i]);
+      if (errorMatch == AT_FRAMER_ERROR_LEN) {
+        errorSeen = true;
+      }
+    }
+  }
+  return Status();
+}
+
+/**
+ * @brief  Get the status of the answer fed so far.
+ *         An answer which ends with OK and the prompt is successful even if
+ *         its data contain an ERROR line.
+ * @param  None
+ * @retval AT_FRAME_OK, AT_FRAME_ERROR or AT_FRAME_PENDING.
+ */
+AT_FrameStatus_t AtFramerClass::Status(void)
+{
+  if (okMatch == AT_FRAMER_OK_LEN) {
+    return AT_FRAME_OK;
+  }
+  if (errorSeen) {
+    return AT_FRAME_ERROR;
+  }
+  return AT_FRAME_PENDING;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
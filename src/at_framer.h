@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    at_framer.h
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file contains the prototypes of the framer which finds the
+  *          end and the status of the answers of the es_wifi module.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#ifndef AT_FRAMER_H
+#define AT_FRAMER_H
+
+#include <inttypes.h>
+
+/* End of a successful answer, followed by the command prompt               */
+#define AT_FRAMER_OK_STRING      "\r\nOK\r\n> "
+#define AT_FRAMER_OK_LEN         (sizeof(AT_FRAMER_OK_STRING) - 1)
+/* Start of the line reporting a failure                                     */
+#define AT_FRAMER_ERROR_STRING   "\r\nERROR"
+#define AT_FRAMER_ERROR_LEN      (sizeof(AT_FRAMER_ERROR_STRING) - 1)
+
+/* Status of the answer fed so far                                          */
+typedef enum {
+  AT_FRAME_PENDING = 0,                /*!< no status yet                    */
+  AT_FRAME_OK,                         /*!< answer ends with OK and prompt   */
+  AT_FRAME_ERROR,                      /*!< answer reports an error          */
+} AT_FrameStatus_t;
+
+/* Finds the status of an answer while its bytes are received: each byte is
+   looked at once, whatever the way the answer is split.                     */
+class AtFramerClass {
+
+  private :
+    uint8_t okFail[AT_FRAMER_OK_LEN];     // fallback of the OK matcher
+    uint8_t errorFail[AT_FRAMER_ERROR_LEN]; // fallback of the ERROR matcher
+    uint8_t okMatch;                      // bytes of the OK string matched
+    uint8_t errorMatch;                   // bytes of the ERROR string matched
+    bool errorSeen;                       // an ERROR line was received
+
+    static void At_Framer_Build(const char *pattern, uint8_t len, uint8_t *fail);
+    static uint8_t At_Framer_Step(const char *pattern, const uint8_t *fail,
+                                  uint8_t match, uint8_t c);
+
+  public:
+
+    AtFramerClass();
+
+    void Reset(void);
+    AT_FrameStatus_t Feed(const uint8_t *data, uint16_t len);
+    AT_FrameStatus_t Status(void);
+};
+
+#endif // AT_FRAMER_H
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -36,6 +36,60 @@
 #define __DRIVER_H
 
 
+/* Set to 0 to compile the statistics of the exchanges out                  */
+#ifndef IO_STATS
+  #define IO_STATS  1
+#endif
+
+/* Statistics of the exchanges with the device                              */
+typedef struct {
+  uint32_t Transactions;               /*!< command/response exchanges       */
+  uint32_t TransactionTime;            /*!< time spent in exchanges (us)     */
+  uint32_t DelayTime;                  /*!< deliberate delays in them (us)   */
+  uint32_t BytesSent;                  /*!< bytes sent, padding included     */
+  uint32_t BytesReceived;              /*!< bytes received                   */
+  uint32_t Timeouts;                   /*!< waits aborted on timeout         */
+  uint32_t WaitTime;                   /*!< time waiting for the device (us) */
+  uint32_t TransferTime;               /*!< time clocking the bytes (us)     */
+  uint32_t MaxWaitTime;                /*!< longest wait for the device (us) */
+} IO_Stats_t;
+
+/* Update of the statistics by the drivers, they keep them in Stats          */
+#if IO_STATS
+  #define IO_STATS_TIME()             micros()
+  #define IO_STATS_ADD(field, value)  (Stats.field += (value))
+  #define IO_STATS_MAX(field, value)  do {                                  \
+                                        if ((value) > Stats.field) {        \
+                                          Stats.field = (value);            \
+                                        }                                   \
+                                      } while (0)
+#else
+  #define IO_STATS_TIME()             0
+  #define IO_STATS_ADD(field, value)  ((void)(value))
+  #define IO_STATS_MAX(field, value)  ((void)(value))
+#endif
+
+/* Piece of a frame, a frame can be sent from several buffers               */
+typedef struct {
+  uint8_t *Data;                       /*!< pointer to the bytes             */
+  uint16_t Len;                        /*!< number of bytes                  */
+} IO_Segment_t;
+
+/* How IO_Init() gets the device ready                                      */
+typedef enum {
+  IO_INIT_COLD = 0,                    /*!< reset the device                 */
+  IO_INIT_WARM,                        /*!< use the device already running   */
+} IO_InitMode_t;
+
+/* Progress of a non-blocking exchange                                     */
+typedef enum {
+  IO_STATE_IDLE = 0,                   /*!< no exchange started              */
+  IO_STATE_SEND,                       /*!< command waiting for the device   */
+  IO_STATE_WAIT,                       /*!< waiting for the answer           */
+  IO_STATE_DONE,                       /*!< answer received                  */
+  IO_STATE_ERROR,                      /*!< exchange timed out               */
+} IO_State_t;
+
 /* virtual class necessary to abstract the means of communication between
    the uC and the device.                                                    */
 
@@ -48,11 +102,21 @@ class DriverClass {
 
   public :
 
-    virtual int8_t IO_Init(void) = 0;
+    virtual int8_t IO_Init(IO_InitMode_t mode) = 0;
     virtual void IO_DeInit(void) = 0;
     virtual void IO_Delay(uint32_t) = 0;
     virtual int16_t IO_Send(uint8_t *, uint16_t len, uint32_t) = 0;
+    virtual int16_t IO_SendSegments(IO_Segment_t *, uint8_t count, uint32_t) = 0;
     virtual int16_t IO_Receive(uint8_t *, uint16_t len, uint32_t) = 0;
+    virtual int16_t IO_ReceiveSegments(IO_Segment_t *, uint8_t count, uint32_t) = 0;
+    virtual int8_t IO_Start(uint8_t *, uint16_t len, uint8_t *, uint16_t size, uint32_t) = 0;
+    virtual IO_State_t IO_Poll(void) = 0;
+    virtual int16_t IO_Complete(void) = 0;
+    virtual void IO_GetStats(IO_Stats_t *) = 0;
+    virtual void IO_ResetStats(void) = 0;
+    virtual void IO_SetCSTiming(uint16_t, uint16_t) {}
+    virtual void IO_SetSpeed(uint32_t) = 0;
+    virtual uint32_t IO_GetSpeed(void) = 0;
 };
 
 #endif /*__DRIVER_H*/
@@ -70,6 +70,111 @@
 #ifndef ES_WIFI_PAYLOAD_SIZE
   #define ES_WIFI_PAYLOAD_SIZE          1200
 #endif
+/* Set to 0 to always send the socket settings, even when the module already
+   has them                                                                  */
+#ifndef ES_WIFI_SHADOW_PARAMS
+  #define ES_WIFI_SHADOW_PARAMS         1
+#endif
+
+/* Oldest firmware revision accepting the length with the data (S3), coded
+   as (major << 24) | (minor << 16) | (patch << 8) | build. Older ones use
+   S1 then S0.                                                               */
+#ifndef ES_WIFI_S3_MIN_FW_REV
+  #define ES_WIFI_S3_MIN_FW_REV         0x03050205
+#endif
+
+/* Set to 1 to try to use the module without resetting it at init           */
+#ifndef ES_WIFI_WARM_START
+  #define ES_WIFI_WARM_START            0
+#endif
+/* Timeouts of the classes of commands in ms                                 */
+#ifndef ES_WIFI_CONFIG_TIMEOUT
+  #define ES_WIFI_CONFIG_TIMEOUT        ES_WIFI_TIMEOUT
+#endif
+#ifndef ES_WIFI_JOIN_TIMEOUT
+  #define ES_WIFI_JOIN_TIMEOUT          10000
+#endif
+#ifndef ES_WIFI_SCAN_TIMEOUT
+  #define ES_WIFI_SCAN_TIMEOUT          ES_WIFI_TIMEOUT
+#endif
+#ifndef ES_WIFI_DNS_TIMEOUT
+  #define ES_WIFI_DNS_TIMEOUT           ES_WIFI_TIMEOUT
+#endif
+#ifndef ES_WIFI_SLOW_TIMEOUT
+  #define ES_WIFI_SLOW_TIMEOUT          ES_WIFI_TIMEOUT
+#endif
+
+/* Set to 1 to shorten the timeout of the configuration commands to the
+   observed latency of the module, but not below ES_WIFI_MIN_TIMEOUT ms. A
+   command which times out fails at once; its answer is drained before the
+   next command, waiting for it up to ES_WIFI_CONFIG_TIMEOUT                 */
+#ifndef ES_WIFI_ADAPTIVE_TIMEOUT
+  #define ES_WIFI_ADAPTIVE_TIMEOUT      0
+#endif
+#ifndef ES_WIFI_MIN_TIMEOUT
+  #define ES_WIFI_MIN_TIMEOUT           20
+#endif
+/* Number of the last AT transactions kept in RAM, a power of 2. Set to 0 to
+   remove the journal                                                        */
+#ifndef ES_WIFI_JOURNAL_SIZE
+  #define ES_WIFI_JOURNAL_SIZE          16
+#endif
+/* Latency histograms of the AT commands: set ES_WIFI_LATENCY_STATS to 0 to
+   remove them. Up to ES_WIFI_LATENCY_CMDS commands are tracked, bucket i
+   counts the latencies from 2^i to 2^(i+1) us, the last one all above      */
+#ifndef ES_WIFI_LATENCY_STATS
+  #define ES_WIFI_LATENCY_STATS         1
+#endif
+#ifndef ES_WIFI_LATENCY_CMDS
+  #define ES_WIFI_LATENCY_CMDS          8
+#endif
+#ifndef ES_WIFI_LATENCY_BUCKETS
+  #define ES_WIFI_LATENCY_BUCKETS       24
+#endif
+/* Recovery of a module which stops answering: after ES_WIFI_RECOVERY_THRESHOLD
+   exchanges in a row without answer, the link is resynchronized, else the
+   module is reset, the network joined again and the client sockets closed.
+   A failed recovery is retried after a delay doubled each time, from
+   ES_WIFI_RECOVERY_BACKOFF_MIN to ES_WIFI_RECOVERY_BACKOFF_MAX ms. Set
+   ES_WIFI_RECOVERY to 0 to remove it                                        */
+#ifndef ES_WIFI_RECOVERY
+  #define ES_WIFI_RECOVERY              1
+#endif
+#ifndef ES_WIFI_RECOVERY_THRESHOLD
+  #define ES_WIFI_RECOVERY_THRESHOLD    3
+#endif
+#ifndef ES_WIFI_RECOVERY_BACKOFF_MIN
+  #define ES_WIFI_RECOVERY_BACKOFF_MIN  500
+#endif
+#ifndef ES_WIFI_RECOVERY_BACKOFF_MAX
+  #define ES_WIFI_RECOVERY_BACKOFF_MAX  60000
+#endif
+/* Data read ahead from each TCP socket, in bytes: the small reads are
+   served from it, it is filled by one read of its size. UDP sockets are
+   never read ahead. It takes ES_WIFI_SOCKET_RX_BUFFER_SIZE * MAX_SOCK_NUM
+   bytes of RAM, 4800 by default. Set to 0 to remove it                     */
+#ifndef ES_WIFI_SOCKET_RX_BUFFER_SIZE
+  #define ES_WIFI_SOCKET_RX_BUFFER_SIZE ES_WIFI_PAYLOAD_SIZE
+#endif
+/* Timeout in ms of the read done by available() and peek() when no data are
+   buffered: the module waits for data ES_WIFI_PREFETCH_TIMEOUT -
+   TIMEOUT_OFFSET ms. The blocking reads let the module wait for their own
+   timeout: the read timeout is sent again when the two alternate           */
+#ifndef ES_WIFI_PREFETCH_TIMEOUT
+  #define ES_WIFI_PREFETCH_TIMEOUT      (TIMEOUT_OFFSET + 10U)
+#endif
+/* Small writes of a client are gathered in a buffer of this size for each
+   socket. It is sent when full, on flush(), stop() and before a read, or by
+   the first write(), connected() or available() more than ES_WIFI_TX_LINGER
+   ms after it got its first byte. A write is then reported done before it
+   is sent: a failure is only seen by flush() and stop(), through
+   getWriteError(). 0, the default, sends each write at once                */
+#ifndef ES_WIFI_SOCKET_TX_BUFFER_SIZE
+  #define ES_WIFI_SOCKET_TX_BUFFER_SIZE 0
+#endif
+#ifndef ES_WIFI_TX_LINGER
+  #define ES_WIFI_TX_LINGER             20
+#endif
 #ifndef TIMEOUT_OFFSET
   #define TIMEOUT_OFFSET                100U
 #endif
@@ -53,6 +53,22 @@
 #include "spi_drv.h"
 #include "pins_arduino.h"
 
+/* Instance and pin served by the data ready interrupt                       */
+static SpiDrvClass *DataReadyOwner = NULL;
+static uint8_t DataReadyPin;
+
+/**
+ * @brief  Data ready pin interrupt handler.
+ * @param  None
+ * @retval None
+ */
+static void Spi_Data_Ready_IRQHandler(void)
+{
+  if (DataReadyOwner != NULL) {
+    DataReadyOwner->Spi_Data_Ready_Event(digitalRead(DataReadyPin));
+  }
+}
+
 /**
  * @brief  Constructor.
  * @param  SPIx   : SPI interface
@@ -70,6 +86,17 @@ SpiDrvClass::SpiDrvClass(SPIClass *SPIx, uint8_t cs, uint8_t spiIRQ,
   spiIRQPin = spiIRQ;
   wakeupPin = wakeup;
   resetPin = reset;
+  dataReadyIrq = false;
+  dataReadyState = LOW;
+  Settings_43362 = NULL;
+  clockMax = SPI_CLOCK_MAX;
+  clock = 0;
+  csSelected = false;
+  csSetupTime = SPI_CS_SETUP_US;
+  csHoldTime = SPI_CS_HOLD_US;
+  asyncState = IO_STATE_IDLE;
+  asyncLen = 0;
+  IO_ResetStats();
 }
 
 /**
@@ -80,7 +107,9 @@ SpiDrvClass::SpiDrvClass(SPIClass *SPIx, uint8_t cs, uint8_t spiIRQ,
 void SpiDrvClass::Spi_Slave_Select()
 {
   digitalWrite(csPin, LOW);
-  delay(10);
+  csSelected = true;
+  delayMicroseconds(csSetupTime);
+  IO_STATS_ADD(DelayTime, csSetupTime);
 }
 
 /**
@@ -91,7 +120,23 @@ void SpiDrvClass::Spi_Slave_Select()
 void SpiDrvClass::Spi_Slave_Deselect()
 {
   digitalWrite(csPin, HIGH);
-  delay(10);
+  if (csSelected) {
+    csSelected = false;
+    delayMicroseconds(csHoldTime);
+    IO_STATS_ADD(DelayTime, csHoldTime);
+  }
+}
+
+/**
+ * @brief  Set the chip select timing.
+ * @param  setup_us : delay between select and the first clock, in us
+ * @param  hold_us  : delay after deselect, in us
+ * @retval None
+ */
+void SpiDrvClass::Spi_Set_CS_Timing(uint16_t setup_us, uint16_t hold_us)
+{
+  csSetupTime = setup_us;
+  csHoldTime = hold_us;
 }
 
 /**
@@ -101,11 +146,59 @@ void SpiDrvClass::Spi_Slave_Deselect()
  */
 uint8_t SpiDrvClass::Spi_Get_Data_Ready_State()
 {
+  if (dataReadyIrq) {
+    return dataReadyState;
+  }
   return digitalRead(spiIRQPin);
 }
 
+/**
+ * @brief  Notify an edge on the data ready line.
+ *         Called from the pin interrupt. A host build without the pin can
+ *         call it directly to simulate the device.
+ * @param  state : new level of the line
+ * @retval None
+ */
+void SpiDrvClass::Spi_Data_Ready_Event(uint8_t state)
+{
+  dataReadyState = state;
+}
+
+/**
+ * @brief  Wait for the data ready line to reach a level.
+ *         When the pin is interrupt driven the core sleeps between edges, the
+ *         tick interrupt still wakes it up to check the timeout.
+ * @param  state   : expected level
+ * @param  timeout : timeout in ms
+ * @retval 0 if the level is reached, -1 on timeout.
+ */
+int8_t SpiDrvClass::Spi_Wait_Data_Ready(uint8_t state, uint32_t timeout)
+{
+  int8_t ret = 0;                        // returned status
+  uint32_t start = millis();             // start time for timeout
+  uint32_t begin = IO_STATS_TIME();      // start time of the wait
+  uint32_t wait;                         // duration of the wait
+
+  while (Spi_Get_Data_Ready_State() != state) {
+    if ((millis() - start) >= timeout) {
+      IO_STATS_ADD(Timeouts, 1);
+      ret = -1;
+      break;
+    }
+    if (dataReadyIrq) {
+      __WFI();
+    }
+  }
+  wait = IO_STATS_TIME() - begin;
+  IO_STATS_ADD(WaitTime, wait);
+  IO_STATS_MAX(MaxWaitTime, wait);
+  return ret;
+}
+
 /**
  * @brief  Reset the WiFi device.
+ *         Returns as soon as the device raises the data ready line to send
+ *         its prompt, after SPI_BOOT_TIMEOUT at most.
  * @param  None
  * @retval None
  */
@@ -113,19 +206,56 @@ void SpiDrvClass::Spi_Wifi_Reset()
 {
   digitalWrite(resetPin, LOW);
   delay(10);
+  if (dataReadyIrq) {
+    // the line is low while the device is held in reset
+    dataReadyState = digitalRead(spiIRQPin);
+  }
   digitalWrite(resetPin, HIGH);
-  delay(500);
+  Spi_Wait_Data_Ready(HIGH, SPI_BOOT_TIMEOUT);
+}
+
+/**
+ * @brief  Configure the SPI clock.
+ * @param  speed : clock in Hz
+ * @retval None
+ */
+void SpiDrvClass::Spi_Set_Clock(uint32_t speed)
+{
+  if (Settings_43362 != NULL) {
+    ISM43362->endTransaction();
+    delete Settings_43362;
+  }
+  Settings_43362 = new SPISettings(speed, MSBFIRST, SPI_MODE0);
+  ISM43362->beginTransaction(*Settings_43362);
+  clock = speed;
+}
+
+/**
+ * @brief  Exchange a block of bytes in place.
+ * @param  data : bytes to send, replaced by the bytes received
+ * @param  len  : number of bytes
+ * @retval None
+ */
+void SpiDrvClass::Spi_Transfer(uint8_t *data, uint16_t len)
+{
+  uint32_t begin = IO_STATS_TIME();      // start time of the transfer
+
+  ISM43362->transfer(data, len);
+  IO_STATS_ADD(TransferTime, IO_STATS_TIME() - begin);
 }
 
 /**
  * @brief  Initialize the SPI
- * @param  None
+ * @param  mode : IO_INIT_COLD to reset the device, IO_INIT_WARM to use the
+ *                device if it is already running and waiting for a command.
+ *                A warm start keeps the clock chosen by the previous cold
+ *                start, or the fastest one. The caller has to check that the
+ *                device answers.
  * @retval : 0 if init success, -1 otherwise.
  */
-int8_t SpiDrvClass::IO_Init(void)
+int8_t SpiDrvClass::IO_Init(IO_InitMode_t mode)
 {
   uint8_t Prompt[6];                     // data receive
-  uint32_t start;                        // start time for timeout
   uint16_t dummy_send = 0x0A0A;          // data to feed the clock
   uint16_t read_value;                   // data read
 
@@ -134,45 +264,63 @@ int8_t SpiDrvClass::IO_Init(void)
   digitalWrite(wakeupPin, LOW);
 
   pinMode(spiIRQPin, INPUT);
+#if SPI_DATA_READY_IRQ
+  if (digitalPinToInterrupt(spiIRQPin) != NOT_AN_INTERRUPT) {
+    DataReadyOwner = this;
+    DataReadyPin = spiIRQPin;
+    dataReadyState = digitalRead(spiIRQPin);
+    attachInterrupt(digitalPinToInterrupt(spiIRQPin), Spi_Data_Ready_IRQHandler, CHANGE);
+    dataReadyIrq = true;
+  }
+#endif
 
   pinMode(resetPin, OUTPUT);
 
   pinMode(csPin, OUTPUT);
   digitalWrite(csPin, HIGH);
 
-  /* Clock = 10MHz (Inventek Wi-Fi module supports up to 20MHz)               */
-  Settings_43362 = new SPISettings(10000000, MSBFIRST, SPI_MODE0);
-  ISM43362->beginTransaction(*Settings_43362);
+  if (mode == IO_INIT_WARM) {
+    /* A running device keeps the data ready line high while it waits for a
+       command                                                              */
+    if (Spi_Get_Data_Ready_State() != HIGH) {
+      return -1;
+    }
+    Spi_Set_Clock((clock != 0) ? clock : clockMax);
+    return 0;
+  }
 
-  Spi_Wifi_Reset();
+  /* Start from the fastest clock and slow down until the prompt sent by the
+     device after reset is received without corruption.                     */
+  for (uint32_t speed = clockMax; speed >= SPI_CLOCK_MIN; speed /= 2) {
+    Spi_Set_Clock(speed);
 
-  Spi_Slave_Select();
+    Spi_Wifi_Reset();
 
-  start = millis();
+    Spi_Slave_Select();
 
-  for (uint8_t count = 0; count < 6; count += 2) {
-    read_value = ISM43362->transfer16(dummy_send);
-    Prompt[count] = (uint8_t)(read_value & 0x00FF);
-    Prompt[count + 1] = (uint8_t)((read_value & 0xFF00) >> 8);
-  }
+    for (uint8_t count = 0; count < 6; count += 2) {
+      read_value = ISM43362->transfer16(dummy_send);
+      Prompt[count] = (uint8_t)(read_value & 0x00FF);
+      Prompt[count + 1] = (uint8_t)((read_value & 0xFF00) >> 8);
+    }
 
-  while (Spi_Get_Data_Ready_State()) {
-    if ((millis() - start) > 100) {
+    if (Spi_Wait_Data_Ready(LOW, 100) != 0) {
       Spi_Slave_Deselect();
       printf("timeout io_init\n\r");
-      return -1;
+      continue;
     }
-  }
 
-  Spi_Slave_Deselect();
+    Spi_Slave_Deselect();
 
-  // Check receive sequence
-  if ((Prompt[0] != 0x15) || (Prompt[1] != 0x15) || (Prompt[2] != '\r') ||
-      (Prompt[3] != '\n') || (Prompt[4] != '>') || (Prompt[5] != ' ')) {
-    return -1;
+    // Check receive sequence
+    if ((Prompt[0] == 0x15) && (Prompt[1] == 0x15) && (Prompt[2] == '\r') &&
+        (Prompt[3] == '\n') && (Prompt[4] == '>') && (Prompt[5] == ' ')) {
+      return 0;
+    }
   }
 
-  return 0;
+  clock = 0;
+  return -1;
 }
 
 /**
@@ -182,6 +330,11 @@ int8_t SpiDrvClass::IO_Init(void)
  */
 void SpiDrvClass::IO_DeInit(void)
 {
+  if (dataReadyIrq) {
+    detachInterrupt(digitalPinToInterrupt(spiIRQPin));
+    dataReadyIrq = false;
+    DataReadyOwner = NULL;
+  }
   ISM43362->endTransaction();
   ISM43362->end();
 }
@@ -194,6 +347,61 @@ void SpiDrvClass::IO_DeInit(void)
 void SpiDrvClass::IO_Delay(uint32_t time)
 {
   delay(time);
+  IO_STATS_ADD(DelayTime, time * 1000);
+}
+
+/**
+ * @brief  Get the statistics of the exchanges with the device
+ * @param  stats : where to copy the counters
+ * @retval None
+ */
+void SpiDrvClass::IO_GetStats(IO_Stats_t *stats)
+{
+  if (stats != NULL) {
+    *stats = Stats;
+  }
+}
+
+/**
+ * @brief  Reset the statistics counters
+ * @param  None
+ * @retval None
+ */
+void SpiDrvClass::IO_ResetStats(void)
+{
+  memset(&Stats, 0, sizeof(Stats));
+}
+
+/**
+ * @brief  Set the chip select timing
+ * @param  setup_us : delay between select and the first clock, in us
+ * @param  hold_us  : delay after deselect, in us
+ * @retval None
+ */
+void SpiDrvClass::IO_SetCSTiming(uint16_t setup_us, uint16_t hold_us)
+{
+  Spi_Set_CS_Timing(setup_us, hold_us);
+}
+
+/**
+ * @brief  Set the fastest SPI clock probed by the next IO_Init()
+ * @param  speed : clock in Hz, raised to SPI_CLOCK_MIN, the slowest clock
+ *                 probed
+ * @retval None
+ */
+void SpiDrvClass::IO_SetSpeed(uint32_t speed)
+{
+  clockMax = (speed < SPI_CLOCK_MIN) ? SPI_CLOCK_MIN : speed;
+}
+
+/**
+ * @brief  Get the SPI clock chosen by IO_Init()
+ * @param  None
+ * @retval clock in Hz, 0 if the device has not been initialized.
+ */
+uint32_t SpiDrvClass::IO_GetSpeed(void)
+{
+  return clock;
 }
 
 /**
@@ -205,105 +413,281 @@ void SpiDrvClass::IO_Delay(uint32_t time)
  */
 int16_t SpiDrvClass::IO_Send(uint8_t *pdata,  uint16_t len, uint32_t timeout)
 {
-  uint8_t Padding[2];              // padding data
-  uint32_t start;                  // start time for timeout
-  int data_tx = 0;                 // data really send
-  uint16_t data_send;              // data to send
+  IO_Segment_t seg = {pdata, len};
 
-  start = millis();
+  return IO_SendSegments(&seg, 1, timeout);
+}
+
+/**
+ * @brief  Send Wi-Fi Data gathered from several buffers through SPI.
+ *         The buffers are sent back to back within the same chip select.
+ * @param  seg     : array of buffers
+ * @param  nseg    : number of buffers
+ * @param  timeout : send timeout in ms
+ * @retval Length of sent data, -1 if send fail
+ */
+int16_t SpiDrvClass::IO_SendSegments(IO_Segment_t *seg, uint8_t nseg, uint32_t timeout)
+{
+  uint8_t Block[SPI_BLOCK_SIZE];   // words to send, in bus byte order
+  uint16_t data_tx = 0;            // data really send
+  uint16_t count = 0;              // number of bytes in the block
+  uint32_t start = IO_STATS_TIME(); // start time of the exchange
+
+  IO_STATS_ADD(Transactions, 1);
 
   // Wait device ready to receive data
-  while (!Spi_Get_Data_Ready_State()) {
-    if ((millis() - start) > timeout) {
-      Spi_Slave_Deselect();
-      return -1;
-    }
+  if (Spi_Wait_Data_Ready(HIGH, timeout) != 0) {
+    Spi_Slave_Deselect();
+    IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - start);
+    return -1;
   }
 
   // Send data
   Spi_Slave_Select();
-  for (data_tx = 0; data_tx < len; data_tx += 2) {
-    if (data_tx == len - 1) {
-      // Data to send are odd, need padding
-      Padding[0] = pdata[len - 1];
-      Padding[1] = '\n';
-      data_send = Padding[0] | (Padding[1] << 8);
-      ISM43362->transfer16(data_send);
-    } else {
-      data_send = pdata[data_tx] | (pdata[data_tx + 1] << 8);
-      ISM43362->transfer16(data_send);
+  for (uint8_t n = 0; n < nseg; n++) {
+    for (uint16_t i = 0; i < seg[n].Len; i++) {
+      // Words are clocked MSB first: swap each pair of bytes
+      Block[count ^ 1] = seg[n].Data[i];
+      if (++count == SPI_BLOCK_SIZE) {
+        Spi_Transfer(Block, count);
+        IO_STATS_ADD(BytesSent, count);
+        count = 0;
+      }
     }
+    data_tx += seg[n].Len;
   }
+  if (count & 1) {
+    // Data to send are odd, need padding
+    Block[count ^ 1] = '\n';
+    count++;
+  }
+  if (count > 0) {
+    Spi_Transfer(Block, count);
+    IO_STATS_ADD(BytesSent, count);
+  }
+  IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - start);
   return data_tx;
 }
 
 /**
  * @brief  Receive Wi-Fi Data from SPI
  * @param  pdata   : pointer to data
- * @param  len     : Data length in byte
+ * @param  len     : Data length in byte, 0 for no limit
  * @param  timeout : send timeout in mS
  * @retval Length of received data (payload)
+ * @note   Data are received by 16-bit words: if len is odd, one more byte
+ *         may be written in pdata.
  */
 int16_t SpiDrvClass::IO_Receive(uint8_t *pData, uint16_t len, uint32_t timeout)
+{
+  IO_Segment_t seg = {pData, 0xFFFE};
+
+  if ((len != 0) && (len < 0xFFFE)) {
+    seg.Len = (len + 1) & ~1;
+  }
+  return IO_ReceiveSegments(&seg, 1, timeout);
+}
+
+/**
+ * @brief  Receive Wi-Fi Data from SPI and scatter them in several buffers.
+ *         Each buffer is filled in turn, the reception stops when the
+ *         device has no more data or when all buffers are full.
+ * @param  seg     : array of buffers
+ * @param  nseg    : number of buffers
+ * @param  timeout : send timeout in mS
+ * @retval Length of received data (payload)
+ */
+int16_t SpiDrvClass::IO_ReceiveSegments(IO_Segment_t *seg, uint8_t nseg, uint32_t timeout)
 {
   int16_t length = 0;                 // length of data receive
-  uint8_t tmp[2];                     // 2 bytes buffer of receive
+  uint8_t n = 0;                      // current buffer
+  uint16_t pos = 0;                   // position in the current buffer
+  uint8_t *p;                         // where to receive
+  uint16_t count;                     // number of bytes in the block
+  uint8_t tmp;                        // byte being swapped
+  uint16_t read_value;                // word read
   uint32_t start;                     // start time for timeout
-  uint16_t dummy_send = 0x0A0A;       // data to feed the clock
-  uint16_t read_value;                // data read
-
-  start = millis();
+  uint32_t begin = IO_STATS_TIME();   // start time of the exchange
+  uint32_t xfer;                      // start time of a transfer
 
   Spi_Slave_Deselect();
 
   // Wait device reports that it has data to send
-  while (!Spi_Get_Data_Ready_State()) {
-    if ((millis() - start) >= timeout) {
-      return 0;
-    }
+  if (Spi_Wait_Data_Ready(HIGH, timeout) != 0) {
+    IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - begin);
+    return 0;
   }
 
   // Receive device data
   Spi_Slave_Select();
   start = millis();
   while (Spi_Get_Data_Ready_State()) {
-    if ((length < len) || (!len)) {
-      read_value = ISM43362->transfer16(dummy_send);
-      tmp[0] = (uint8_t)(read_value & 0x00FF);
-      tmp[1] = (uint8_t)((read_value & 0xFF00) >> 8);
-
-      /* let some time to hardware to change data ready signal (the IRQpin) */
-      if (tmp[1] == 0x15) {
-        IO_Delay(1);
+    while ((n < nseg) && (pos == seg[n].Len)) {
+      n++;
+      pos = 0;
+    }
+    if (n == nseg) {
+      break;
+    }
+    p = seg[n].Data + pos;
+    count = seg[n].Len - pos;
+    if (count >= 2) {
+      if (count > SPI_BLOCK_SIZE) {
+        count = SPI_BLOCK_SIZE;
       }
-      /*This the last data */
-      if (!Spi_Get_Data_Ready_State()) {
-        if (tmp[1] == 0x15) {
-          // Only 1 byte of data, the other one is padding
-          if ((tmp[0] != 0x15)) {
-            pData[0] = tmp[0];
-            length++;
-          }
-          break;
-        }
+      count &= ~1;
+      // Feed the clock with dummy data, received words replace them in place
+      memset(p, 0x0A, count);
+      Spi_Transfer(p, count);
+      for (uint16_t i = 0; i < count; i += 2) {
+        tmp = p[i];
+        p[i] = p[i + 1];
+        p[i + 1] = tmp;
       }
+      pos += count;
+      tmp = p[count - 1];
+    } else {
+      // The word is split between the end of this buffer and the next one
+      xfer = IO_STATS_TIME();
+      read_value = ISM43362->transfer16(0x0A0A);
+      IO_STATS_ADD(TransferTime, IO_STATS_TIME() - xfer);
+      *p = (uint8_t)(read_value & 0x00FF);
+      tmp = (uint8_t)((read_value & 0xFF00) >> 8);
+      pos++;
+      while ((n < nseg) && (pos == seg[n].Len)) {
+        n++;
+        pos = 0;
+      }
+      if (n < nseg) {
+        seg[n].Data[pos++] = tmp;
+        count = 2;
+      }
+    }
+    length += count;
 
-      pData[0] = tmp[0];
-      pData[1] = tmp[1];
-      length += 2;
-      pData  += 2;
+    /* let some time to hardware to change data ready signal (the IRQpin) */
+    if (tmp == 0x15) {
+      IO_Delay(1);
+    }
 
-      if ((millis() - start) >= timeout) {
-        Spi_Slave_Deselect();
-        return 0;
-      }
-    } else {
-      break;
+    if ((millis() - start) >= timeout) {
+      Spi_Slave_Deselect();
+      IO_STATS_ADD(Timeouts, 1);
+      IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - begin);
+      return 0;
     }
   }
 
   Spi_Slave_Deselect();
+  IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - begin);
+  IO_STATS_ADD(BytesReceived, length);
+
+  /* Once its data are exhausted the device pads the block with 0x15 */
+  while (length > 0) {
+    if (pos == 0) {
+      n--;
+      pos = seg[n].Len;
+    } else if (seg[n].Data[pos - 1] == 0x15) {
+      pos--;
+      length--;
+    } else {
+      break;
+    }
+  }
   return length;
 }
 
+/**
+ * @brief  Start a non-blocking exchange: a command and its answer.
+ *         The exchange is then driven by IO_Poll() and collected with
+ *         IO_Complete(). Both buffers must remain valid until then.
+ * @param  cmd     : command to send
+ * @param  len     : command length in byte
+ * @param  answer  : where to receive the answer
+ * @param  size    : answer buffer size in byte, 0 for no limit
+ * @param  timeout : timeout of the whole exchange in ms
+ * @retval 0 if the exchange is started, -1 if one is already in progress.
+ */
+int8_t SpiDrvClass::IO_Start(uint8_t *cmd, uint16_t len, uint8_t *answer, uint16_t size,
+                             uint32_t timeout)
+{
+  if ((asyncState == IO_STATE_SEND) || (asyncState == IO_STATE_WAIT)) {
+    return -1;
+  }
+  asyncCmd.Data = cmd;
+  asyncCmd.Len = len;
+  asyncAnswer.Data = answer;
+  asyncAnswer.Len = size;
+  asyncLen = 0;
+  asyncTimeout = timeout;
+  asyncStart = millis();
+  asyncState = IO_STATE_SEND;
+  IO_Poll();
+  return 0;
+}
+
+/**
+ * @brief  Make the non-blocking exchange progress.
+ *         Returns immediately while the device is busy. The command is sent
+ *         and the answer received in one go once the device is ready, these
+ *         transfers only last for the time needed to clock the data.
+ * @param  None
+ * @retval Current state of the exchange.
+ */
+IO_State_t SpiDrvClass::IO_Poll(void)
+{
+  uint32_t elapsed = millis() - asyncStart;
+
+  switch (asyncState) {
+    case IO_STATE_SEND:
+      if (Spi_Get_Data_Ready_State()) {
+        if (IO_Send(asyncCmd.Data, asyncCmd.Len, 0) < 0) {
+          asyncState = IO_STATE_ERROR;
+        } else {
+          asyncState = IO_STATE_WAIT;
+        }
+      } else if (elapsed >= asyncTimeout) {
+        asyncState = IO_STATE_ERROR;
+      }
+      break;
+    case IO_STATE_WAIT:
+      // Deselect the device so that it processes the command
+      Spi_Slave_Deselect();
+      if (Spi_Get_Data_Ready_State()) {
+        asyncLen = IO_Receive(asyncAnswer.Data, asyncAnswer.Len,
+                              (elapsed < asyncTimeout) ? asyncTimeout - elapsed : 1);
+        asyncState = IO_STATE_DONE;
+      } else if (elapsed >= asyncTimeout) {
+        asyncState = IO_STATE_ERROR;
+      }
+      break;
+    default:
+      break;
+  }
+  return asyncState;
+}
+
+/**
+ * @brief  Finish the non-blocking exchange.
+ *         If the exchange is still in progress, wait for its end.
+ * @param  None
+ * @retval Length of the answer, -1 if the exchange failed or none was started.
+ */
+int16_t SpiDrvClass::IO_Complete(void)
+{
+  IO_State_t state;
+
+  while (((state = IO_Poll()) == IO_STATE_SEND) || (state == IO_STATE_WAIT)) {
+    if (dataReadyIrq) {
+      __WFI();
+    }
+  }
+  asyncState = IO_STATE_IDLE;
+  if (state != IO_STATE_DONE) {
+    Spi_Slave_Deselect();
+    return -1;
+  }
+  return asyncLen;
+}
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
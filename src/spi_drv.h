@@ -44,13 +44,67 @@
 #define MAX_TRY_INIT    100
 #define MAX_SIZE_ANSWER 255
 
+/* Number of bytes clocked by a single block transfer. Must be even as the
+   device exchanges 16-bit words.                                            */
+#ifndef SPI_BLOCK_SIZE
+  #define SPI_BLOCK_SIZE  64
+#endif
+
+/* SPI clock range probed at init, from the fastest one (the module supports
+   up to 20MHz) down to the slowest one, halving the clock at each step.     */
+#ifndef SPI_CLOCK_MAX
+  #define SPI_CLOCK_MAX     20000000
+#endif
+#ifndef SPI_CLOCK_MIN
+  #define SPI_CLOCK_MIN     1250000
+#endif
+
+/* Chip select setup and hold times in us. Defaults follow the timing of the
+   ST reference driver, they can be changed with Spi_Set_CS_Timing().       */
+#ifndef SPI_CS_SETUP_US
+  #define SPI_CS_SETUP_US   15
+#endif
+#ifndef SPI_CS_HOLD_US
+  #define SPI_CS_HOLD_US    3
+#endif
+
+/* Longest time the device takes to boot after reset, in ms. It is ready
+   as soon as it raises the data ready line.                                 */
+#ifndef SPI_BOOT_TIMEOUT
+  #define SPI_BOOT_TIMEOUT  500
+#endif
+
+/* Set to 0 to busy-poll the data ready pin instead of waiting for its edge
+   interrupt.                                                                */
+#ifndef SPI_DATA_READY_IRQ
+  #define SPI_DATA_READY_IRQ  1
+#endif
+
 class SpiDrvClass : public DriverClass {
 
   private :
     SPIClass *ISM43362;
     uint8_t csPin;
     SPISettings *Settings_43362;
+    uint32_t clockMax;                    // fastest clock probed at init
+    uint32_t clock;                       // clock chosen at init
     uint8_t spiIRQPin;
+    bool dataReadyIrq;                    // data ready pin is interrupt driven
+    volatile uint8_t dataReadyState;      // level latched by the interrupt
+    bool csSelected;                      // chip select is active
+    uint16_t csSetupTime;                 // chip select setup time in us
+    uint16_t csHoldTime;                  // chip select hold time in us
+    IO_Stats_t Stats;                     // statistics of the exchanges
+    IO_State_t asyncState;                // non-blocking exchange progress
+    IO_Segment_t asyncCmd;                // command of the exchange
+    IO_Segment_t asyncAnswer;             // where to receive the answer
+    int16_t asyncLen;                     // length of the answer received
+    uint32_t asyncStart;                  // start time of the exchange (ms)
+    uint32_t asyncTimeout;                // timeout of the exchange (ms)
+
+    int8_t Spi_Wait_Data_Ready(uint8_t state, uint32_t timeout);
+    void Spi_Set_Clock(uint32_t speed);
+    void Spi_Transfer(uint8_t *data, uint16_t len);
 
   public:
 
@@ -60,12 +114,25 @@ class SpiDrvClass : public DriverClass {
     void Spi_Slave_Select();
     void Spi_Slave_Deselect();
     uint8_t Spi_Get_Data_Ready_State();
+    void Spi_Data_Ready_Event(uint8_t state);
+    void Spi_Set_CS_Timing(uint16_t setup_us, uint16_t hold_us);
 
-    virtual int8_t IO_Init(void);
+    virtual int8_t IO_Init(IO_InitMode_t mode);
     virtual void IO_DeInit(void);
     virtual void IO_Delay(uint32_t time);
     virtual int16_t IO_Send(uint8_t *data, uint16_t len, uint32_t timeout);
+    virtual int16_t IO_SendSegments(IO_Segment_t *seg, uint8_t count, uint32_t timeout);
     virtual int16_t IO_Receive(uint8_t *data, uint16_t len, uint32_t timeout);
+    virtual int16_t IO_ReceiveSegments(IO_Segment_t *seg, uint8_t count, uint32_t timeout);
+    virtual int8_t IO_Start(uint8_t *cmd, uint16_t len, uint8_t *answer, uint16_t size,
+                            uint32_t timeout);
+    virtual IO_State_t IO_Poll(void);
+    virtual int16_t IO_Complete(void);
+    virtual void IO_GetStats(IO_Stats_t *stats);
+    virtual void IO_ResetStats(void);
+    virtual void IO_SetCSTiming(uint16_t setup_us, uint16_t hold_us);
+    virtual void IO_SetSpeed(uint32_t speed);
+    virtual uint32_t IO_GetSpeed(void);
 };
 
 #endif // SPI_DRV_H
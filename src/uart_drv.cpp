@@ -0,0 +1,459 @@
+/**
+  ******************************************************************************
+  * @file    uart_drv.cpp
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file implements the IO operations to deal with the es-wifi
+  *          module over an UART. Reception relies on the interrupt driven
+  *          receive buffer of HardwareSerial, answers are framed by the
+  *          command prompt sent by the module.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2017 STMicroelectronics International N.V.
+  * All rights reserved.</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted, provided that the following conditions are met:
+  *
+  * 1. Redistribution of source code must retain the above copyright notice,
+  *    this list of conditions and the following disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  * 3. Neither the name of STMicroelectronics nor the names of other
+  *    contributors to this software may be used to endorse or promote products
+  *    derived from this software without specific written permission.
+  * 4. This software, including modifications and/or derivative works of this
+  *    software, must execute solely and exclusively on microcontroller or
+  *    microprocessor devices manufactured by or for STMicroelectronics.
+  * 5. Redistribution and use of this software other than as permitted under
+  *    this license is void and will automatically terminate your rights under
+  *    this license.
+  *
+  * THIS SOFTWARE IS PROVIDED BY STMICROELECTRONICS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS, IMPLIED OR STATUTORY WARRANTIES, INCLUDING, BUT NOT
+  * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+  * PARTICULAR PURPOSE AND NON-INFRINGEMENT OF THIRD PARTY INTELLECTUAL PROPERTY
+  * RIGHTS ARE DISCLAIMED TO THE FULLEST EXTENT PERMITTED BY LAW. IN NO EVENT
+  * SHALL STMICROELECTRONICS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+  * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#include <stdbool.h>
+#include <string.h>
+#include "Arduino.h"
+#include "uart_drv.h"
+
+/**
+ * @brief  Constructor.
+ * @param  UARTx  : UART interface
+ * @param  reset  : reset pin
+ * @param  wakeup : wakeup pin
+ * @retval None
+ */
+UARTDrvClass::UARTDrvClass(HardwareSerial *UARTx, uint8_t reset, uint8_t wakeup)
+{
+  ISM43362 = UARTx;
+  wakeupPin = wakeup;
+  resetPin = reset;
+  baudrate = UART_BAUDRATE;
+  initialized = false;
+  rxSeg = NULL;
+  rxCount = 0;
+  asyncState = IO_STATE_IDLE;
+  rxLength = 0;
+  IO_ResetStats();
+}
+
+/**
+ * @brief  Reset the WiFi device.
+ *         The prompt sent once the device has booted is left in the receive
+ *         buffer.
+ * @param  None
+ * @retval None
+ */
+void UARTDrvClass::Uart_Wifi_Reset()
+{
+  digitalWrite(resetPin, LOW);
+  delay(10);
+  digitalWrite(resetPin, HIGH);
+}
+
+/**
+ * @brief  Drop the bytes waiting in the receive buffer.
+ *         Left over of an answer which did not fit in the given buffers.
+ * @param  None
+ * @retval None
+ */
+void UARTDrvClass::Uart_Flush_Input()
+{
+  while (ISM43362->available() > 0) {
+    ISM43362->read();
+  }
+}
+
+/**
+ * @brief  Prepare the reception of an answer.
+ * @param  seg  : array of buffers, NULL to drop the answer
+ * @param  nseg : number of buffers
+ * @retval None
+ */
+void UARTDrvClass::Uart_Start_Receive(IO_Segment_t *seg, uint8_t nseg)
+{
+  rxSeg = seg;
+  rxCount = nseg;
+  rxIndex = 0;
+  rxPos = 0;
+  rxLength = 0;
+  rxLast = 0;
+  rxFramer.Reset();
+}
+
+/**
+ * @brief  Move the bytes waiting in the receive buffer to the answer.
+ *         Each buffer is filled in turn. The data of an answer may contain
+ *         the prompt: it ends the answer only after the OK string or an
+ *         ERROR line. Without buffers, the boot prompt is waited for.
+ * @param  None
+ * @retval true once the answer is complete or all buffers are full.
+ */
+bool UARTDrvClass::Uart_Read_Available(void)
+{
+  int c;
+  uint8_t byte;
+  AT_FrameStatus_t status;
+
+  while ((c = ISM43362->read()) >= 0) {
+    if (rxSeg != NULL) {
+      while ((rxIndex < rxCount) && (rxPos == rxSeg[rxIndex].Len)) {
+        rxIndex++;
+        rxPos = 0;
+      }
+      if (rxIndex == rxCount) {
+        return true;
+      }
+      rxSeg[rxIndex].Data[rxPos++] = (uint8_t)c;
+      rxLength++;
+    }
+    byte = (uint8_t)c;
+    rxLast = (rxLast << 8) | byte;
+    if (rxSeg == NULL) {
+      if (rxLast == UART_PROMPT) {
+        return true;
+      }
+      continue;
+    }
+    status = rxFramer.Feed(&byte, 1);
+    if ((status == AT_FRAME_OK) || ((status == AT_FRAME_ERROR) && (rxLast == UART_PROMPT))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief  Initialize the UART
+ * @param  mode : IO_INIT_COLD to reset the device, IO_INIT_WARM to use the
+ *                device if it is already running: it has to answer an empty
+ *                command with its prompt.
+ * @retval : 0 if init success, -1 otherwise.
+ */
+int8_t UARTDrvClass::IO_Init(IO_InitMode_t mode)
+{
+  uint32_t start;                        // start time for timeout
+  uint32_t timeout = UART_BOOT_TIMEOUT;  // time allowed to get the prompt
+
+  /* pin configuration                                                       */
+  pinMode(wakeupPin, OUTPUT);
+  digitalWrite(wakeupPin, LOW);
+  pinMode(resetPin, OUTPUT);
+
+  ISM43362->begin(baudrate);
+  initialized = true;
+  Uart_Flush_Input();
+
+  if (mode == IO_INIT_WARM) {
+    ISM43362->write('\r');
+    timeout = UART_WARM_TIMEOUT;
+  } else {
+    Uart_Wifi_Reset();
+  }
+
+  // Wait for the prompt sent by the device once booted
+  Uart_Start_Receive(NULL, 0);
+  start = millis();
+  while (!Uart_Read_Available()) {
+    if ((millis() - start) >= timeout) {
+      if (mode == IO_INIT_COLD) {
+        printf("timeout io_init\n\r");
+      }
+      IO_DeInit();
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief  DeInitialize the UART
+ * @param  None
+ * @retval None
+ */
+void UARTDrvClass::IO_DeInit(void)
+{
+  ISM43362->end();
+  initialized = false;
+}
+
+/**
+ * @brief  Delay
+ * @param  Delay in ms
+ * @retval None
+ */
+void UARTDrvClass::IO_Delay(uint32_t time)
+{
+  delay(time);
+  IO_STATS_ADD(DelayTime, time * 1000);
+}
+
+/**
+ * @brief  Get the statistics of the exchanges with the device
+ * @param  stats : where to copy the counters
+ * @retval None
+ */
+void UARTDrvClass::IO_GetStats(IO_Stats_t *stats)
+{
+  if (stats != NULL) {
+    *stats = Stats;
+  }
+}
+
+/**
+ * @brief  Reset the statistics counters
+ * @param  None
+ * @retval None
+ */
+void UARTDrvClass::IO_ResetStats(void)
+{
+  memset(&Stats, 0, sizeof(Stats));
+}
+
+/**
+ * @brief  Set the baud rate of the link. Applied at once if the link is
+ *         open, the device has to be configured accordingly (U2 command).
+ * @param  speed : baud rate
+ * @retval None
+ */
+void UARTDrvClass::IO_SetSpeed(uint32_t speed)
+{
+  baudrate = speed;
+  if (initialized) {
+    ISM43362->flush();
+    ISM43362->end();
+    ISM43362->begin(baudrate);
+  }
+}
+
+/**
+ * @brief  Get the baud rate of the link
+ * @param  None
+ * @retval baud rate, 0 if the device has not been initialized.
+ */
+uint32_t UARTDrvClass::IO_GetSpeed(void)
+{
+  return initialized ? baudrate : 0;
+}
+
+/**
+ * @brief  Send Wi-Fi Data through UART
+ * @param  pdata   : pointer to data
+ * @param  len     : Data length in byte
+ * @param  timeout : send timeout in ms
+ * @retval Length of sent data, -1 if send fail
+ */
+int16_t UARTDrvClass::IO_Send(uint8_t *pdata,  uint16_t len, uint32_t timeout)
+{
+  IO_Segment_t seg = {pdata, len};
+
+  return IO_SendSegments(&seg, 1, timeout);
+}
+
+/**
+ * @brief  Send Wi-Fi Data gathered from several buffers through UART.
+ * @param  seg     : array of buffers
+ * @param  nseg    : number of buffers
+ * @param  timeout : send timeout in ms
+ * @retval Length of sent data, -1 if send fail
+ */
+int16_t UARTDrvClass::IO_SendSegments(IO_Segment_t *seg, uint8_t nseg, uint32_t timeout)
+{
+  uint16_t data_tx = 0;            // data really send
+  uint32_t start = IO_STATS_TIME(); // start time of the exchange
+
+  UNUSED(timeout);
+
+  if (!initialized) {
+    return -1;
+  }
+
+  IO_STATS_ADD(Transactions, 1);
+
+  // Drop what is left of a previous answer
+  Uart_Flush_Input();
+
+  for (uint8_t n = 0; n < nseg; n++) {
+    data_tx += ISM43362->write(seg[n].Data, seg[n].Len);
+  }
+  ISM43362->flush();
+  IO_STATS_ADD(BytesSent, data_tx);
+  IO_STATS_ADD(TransferTime, IO_STATS_TIME() - start);
+  IO_STATS_ADD(TransactionTime, IO_STATS_TIME() - start);
+  return data_tx;
+}
+
+/**
+ * @brief  Receive Wi-Fi Data from UART
+ * @param  pdata   : pointer to data
+ * @param  len     : Data length in byte, 0 for no limit
+ * @param  timeout : receive timeout in mS
+ * @retval Length of received data (payload)
+ */
+int16_t UARTDrvClass::IO_Receive(uint8_t *pData, uint16_t len, uint32_t timeout)
+{
+  IO_Segment_t seg = {pData, 0xFFFE};
+
+  if ((len != 0) && (len < 0xFFFE)) {
+    seg.Len = len;
+  }
+  return IO_ReceiveSegments(&seg, 1, timeout);
+}
+
+/**
+ * @brief  Receive Wi-Fi Data from UART and scatter them in several buffers.
+ *         Each buffer is filled in turn, the reception stops when the
+ *         answer is complete or when all buffers are full.
+ * @param  seg     : array of buffers
+ * @param  nseg    : number of buffers
+ * @param  timeout : time allowed without receiving anything, in mS
+ * @retval Length of received data (payload), also when the timeout expired
+ *         before the end of the answer.
+ */
+int16_t UARTDrvClass::IO_ReceiveSegments(IO_Segment_t *seg, uint8_t nseg, uint32_t timeout)
+{
+  int16_t length;                     // length of the previous check
+  uint32_t start = millis();          // start time for timeout
+  uint32_t begin = IO_STATS_TIME();   // start time of the exchange
+  uint32_t wait = 0;                  // time waiting for the first byte
+  uint32_t total;                     // duration of the exchange
+
+  if (!initialized) {
+    return 0;
+  }
+
+  Uart_Start_Receive(seg, nseg);
+  length = rxLength;
+  while (!Uart_Read_Available()) {
+    if (rxLength != length) {
+      if (length == 0) {
+        wait = IO_STATS_TIME() - begin;
+      }
+      length = rxLength;
+      start = millis();
+    } else if ((millis() - start) >= timeout) {
+      IO_STATS_ADD(Timeouts, 1);
+      break;
+    }
+  }
+  total = IO_STATS_TIME() - begin;
+  if (length == 0) {
+    wait = total;
+  }
+  IO_STATS_ADD(WaitTime, wait);
+  IO_STATS_MAX(MaxWaitTime, wait);
+  IO_STATS_ADD(TransferTime, total - wait);
+  IO_STATS_ADD(TransactionTime, total);
+  IO_STATS_ADD(BytesReceived, rxLength);
+  return rxLength;
+}
+
+/**
+ * @brief  Start a non-blocking exchange: a command and its answer.
+ *         The command is queued in the transmit buffer of the UART, the
+ *         answer is collected by IO_Poll() and IO_Complete(). The answer
+ *         buffer must remain valid until then.
+ * @param  cmd     : command to send
+ * @param  len     : command length in byte
+ * @param  answer  : where to receive the answer
+ * @param  size    : answer buffer size in byte, 0 for no limit
+ * @param  timeout : time allowed without receiving anything, in ms
+ * @retval 0 if the exchange is started, -1 otherwise.
+ */
+int8_t UARTDrvClass::IO_Start(uint8_t *cmd, uint16_t len, uint8_t *answer, uint16_t size,
+                              uint32_t timeout)
+{
+  if (!initialized || (asyncState == IO_STATE_SEND) || (asyncState == IO_STATE_WAIT)) {
+    return -1;
+  }
+  IO_STATS_ADD(Transactions, 1);
+  Uart_Flush_Input();
+  IO_STATS_ADD(BytesSent, ISM43362->write(cmd, len));
+
+  asyncAnswer.Data = answer;
+  asyncAnswer.Len = ((size != 0) && (size < 0xFFFE)) ? size : 0xFFFE;
+  Uart_Start_Receive(&asyncAnswer, 1);
+  asyncTimeout = timeout;
+  asyncStart = millis();
+  asyncState = IO_STATE_WAIT;
+  return 0;
+}
+
+/**
+ * @brief  Make the non-blocking exchange progress: read what has been
+ *         received so far. Never waits.
+ * @param  None
+ * @retval Current state of the exchange.
+ */
+IO_State_t UARTDrvClass::IO_Poll(void)
+{
+  int16_t length = rxLength;          // length before this check
+
+  if (asyncState == IO_STATE_WAIT) {
+    if (Uart_Read_Available()) {
+      IO_STATS_ADD(BytesReceived, rxLength);
+      asyncState = IO_STATE_DONE;
+    } else if (rxLength != length) {
+      asyncStart = millis();
+    } else if ((millis() - asyncStart) >= asyncTimeout) {
+      IO_STATS_ADD(Timeouts, 1);
+      asyncState = IO_STATE_ERROR;
+    }
+  }
+  return asyncState;
+}
+
+/**
+ * @brief  Finish the non-blocking exchange.
+ *         If the exchange is still in progress, wait for its end.
+ * @param  None
+ * @retval Length of the answer, -1 if the exchange failed or none was started.
+ */
+int16_t UARTDrvClass::IO_Complete(void)
+{
+  IO_State_t state;
+
+  while ((state = IO_Poll()) == IO_STATE_WAIT);
+  asyncState = IO_STATE_IDLE;
+  if (state != IO_STATE_DONE) {
+    return -1;
+  }
+  return rxLength;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    uart_drv.h
+  * @author  MCD Application Team, Wi6labs
+  * @brief   This file contains the functions prototypes for es_wifi IO
+  *          operations over an UART.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+#ifndef UART_DRV_H
+#define UART_DRV_H
+
+#include <inttypes.h>
+#include "Arduino.h"
+#include "driver.h"
+#include "at_framer.h"
+
+/* Baud rate of the module UART after reset.                                */
+#ifndef UART_BAUDRATE
+  #define UART_BAUDRATE     115200
+#endif
+
+/* Time given to the module to send its prompt after reset, in ms.          */
+#ifndef UART_BOOT_TIMEOUT
+  #define UART_BOOT_TIMEOUT 2000
+#endif
+
+/* Time given to an already running module to answer, in ms.              */
+#ifndef UART_WARM_TIMEOUT
+  #define UART_WARM_TIMEOUT 100
+#endif
+
+/* Command prompt: sent alone once the device has booted, it ends the
+   answers after their status                                                */
+#define UART_PROMPT         0x0D0A3E20UL  // "\r\n> "
+
+class UARTDrvClass : public DriverClass {
+
+  private :
+    HardwareSerial *ISM43362;
+    uint32_t baudrate;                    // baud rate of the link
+    bool initialized;                     // link is open
+    IO_Stats_t Stats;                     // statistics of the exchanges
+    IO_Segment_t *rxSeg;                  // buffers of the answer
+    uint8_t rxCount;                      // number of buffers
+    uint8_t rxIndex;                      // current buffer
+    uint16_t rxPos;                       // position in the current buffer
+    int16_t rxLength;                     // length of the answer received
+    uint32_t rxLast;                      // last 4 bytes received
+    AtFramerClass rxFramer;               // status of the answer
+    IO_State_t asyncState;                // non-blocking exchange progress
+    IO_Segment_t asyncAnswer;             // where to receive the answer
+    uint32_t asyncStart;                  // time of the last progress (ms)
+    uint32_t asyncTimeout;                // timeout of the exchange (ms)
+
+    void Uart_Start_Receive(IO_Segment_t *seg, uint8_t nseg);
+    bool Uart_Read_Available(void);
+
+  public:
+
+    UARTDrvClass(HardwareSerial *UARTx, uint8_t reset, uint8_t wakeup);
+
+    void Uart_Wifi_Reset();
+    void Uart_Flush_Input();
+
+    virtual int8_t IO_Init(IO_InitMode_t mode);
+    virtual void IO_DeInit(void);
+    virtual void IO_Delay(uint32_t time);
+    virtual int16_t IO_Send(uint8_t *data, uint16_t len, uint32_t timeout);
+    virtual int16_t IO_SendSegments(IO_Segment_t *seg, uint8_t count, uint32_t timeout);
+    virtual int16_t IO_Receive(uint8_t *data, uint16_t len, uint32_t timeout);
+    virtual int16_t IO_ReceiveSegments(IO_Segment_t *seg, uint8_t count, uint32_t timeout);
+    virtual int8_t IO_Start(uint8_t *cmd, uint16_t len, uint8_t *answer, uint16_t size,
+                            uint32_t timeout);
+    virtual IO_State_t IO_Poll(void);
+    virtual int16_t IO_Complete(void);
+    virtual void IO_GetStats(IO_Stats_t *stats);
+    virtual void IO_ResetStats(void);
+    virtual void IO_SetSpeed(uint32_t speed);
+    virtual uint32_t IO_GetSpeed(void);
+};
+
+#endif // UART_DRV_H
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
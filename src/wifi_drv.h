@@ -36,9 +36,11 @@
 #ifndef WiFi_Drv_H
 #define WiFi_Drv_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include "IPAddress.h"
 #include "es_wifi_conf.h"
+#include "driver.h"
 
 /* Exported typedef ----------------------------------------------------------*/
 
@@ -91,6 +93,45 @@ typedef enum {
   ES_WIFI_AP_ERROR    = 0xFF,
 } ES_WIFI_APState_t;
 
+/* Classes of commands, each one has its own timeout */
+typedef enum {
+  ES_WIFI_CMD_CONFIG = 0,           /*!< settings and status of the module */
+  ES_WIFI_CMD_DATA,                 /*!< socket data, given by the socket timeout */
+  ES_WIFI_CMD_JOIN,                 /*!< join of an access point */
+  ES_WIFI_CMD_SCAN,                 /*!< scan of the access points */
+  ES_WIFI_CMD_DNS,                  /*!< DNS lookup, ping and client connection */
+  ES_WIFI_CMD_SLOW,                 /*!< socket closing, server start and messages,
+                                         settings saved to flash and resets */
+  ES_WIFI_CMD_CLASSES
+} ES_WIFI_CmdClass_t;
+
+/* AT transaction recorded in the journal */
+typedef struct {
+  char Cmd[2];                      /*!< command code, such as "P0" */
+  uint8_t Socket;                   /*!< current socket */
+  uint8_t Status;                   /*!< ES_WIFI_Status_t of the transaction */
+  uint16_t Len;                     /*!< payload length, sent or received */
+  uint32_t Start;                   /*!< micros() when the command was sent */
+  uint32_t End;                     /*!< micros() when the answer was received */
+} ES_WIFI_JournalEntry_t;
+
+/* Latency histogram of an AT command */
+typedef struct {
+  char Cmd[2];                      /*!< command code, such as "P0" */
+  uint32_t Count[ES_WIFI_LATENCY_BUCKETS]; /*!< bucket i: latencies from 2^i to 2^(i+1) us */
+} ES_WIFI_Latency_t;
+
+/* Counters of the recovery of the module */
+typedef struct {
+  uint32_t IOFailures;              /*!< exchanges without answer */
+  uint32_t Recoveries;              /*!< recoveries started */
+  uint32_t Resyncs;                 /*!< recoveries done by resynchronizing the link */
+  uint32_t Resets;                  /*!< resets of the module */
+  uint32_t Rejoins;                 /*!< networks joined again */
+  uint32_t Drops;                   /*!< client sockets closed, their connection lost */
+  uint32_t Failures;                /*!< recoveries which failed */
+} ES_WIFI_RecoveryStats_t;
+
 /* Communication interface */
 typedef enum {
   COMM_UART,
@@ -141,12 +182,33 @@ class WiFiDrvClass {
     virtual void ES_WIFI_StopServerMultiConn() = 0;
     virtual bool ES_WIFI_StartClientConnection(uint8_t index) = 0;
     virtual bool ES_WIFI_StopClientConnection(uint8_t index) = 0;
-    virtual void ES_WIFI_ReceiveData(uint8_t Socket, uint8_t *pdata, uint16_t Reqlen, uint16_t *Receivedlen, uint32_t Timeout) = 0;
+    virtual void ES_WIFI_ReceiveData(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *Receivedlen, uint32_t Timeout) = 0;
+    virtual int ES_WIFI_Available(uint8_t Socket) = 0;
+    virtual int ES_WIFI_Peek(uint8_t Socket) = 0;
     virtual bool ES_WIFI_SetConnectionParam(uint8_t Number, ES_WIFI_ConnType_t Type, uint16_t LocalPort, IPAddress Ip = INADDR_NONE) = 0;
-    virtual void ES_WIFI_SendResp(uint8_t Socket, uint8_t *pdata, uint16_t Reqlen, uint16_t *SentLen, uint32_t Timeout) = 0;
+    virtual void ES_WIFI_SendResp(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *SentLen, uint32_t Timeout) = 0;
+    virtual void ES_WIFI_Write(uint8_t Socket, uint8_t *pdata, size_t Reqlen, size_t *SentLen, uint32_t Timeout) = 0;
+    virtual bool ES_WIFI_Flush(uint8_t Socket, bool expired) = 0;
     virtual uint8_t getCurrentSocket(void) = 0;
     virtual int8_t getFreeSocket(void) = 0;
     virtual uint8_t getSocketState(uint8_t socket) = 0;
+    virtual void ES_WIFI_GetIOStats(IO_Stats_t *stats) = 0;
+    virtual void ES_WIFI_ResetIOStats() = 0;
+    virtual void ES_WIFI_SetCSTiming(uint16_t setup_us, uint16_t hold_us) = 0;
+    virtual void ES_WIFI_SetIOSpeed(uint32_t speed) = 0;
+    virtual uint32_t ES_WIFI_GetIOSpeed() = 0;
+    virtual void ES_WIFI_SetWarmStart(bool enable) = 0;
+    virtual uint32_t ES_WIFI_GetBootTime() = 0;
+    virtual void ES_WIFI_SetCmdTimeout(ES_WIFI_CmdClass_t cmdClass, uint32_t timeout, bool adaptive) = 0;
+    virtual uint32_t ES_WIFI_GetCmdTimeout(ES_WIFI_CmdClass_t cmdClass) = 0;
+    virtual uint16_t ES_WIFI_GetJournal(ES_WIFI_JournalEntry_t *entries, uint16_t max) = 0;
+    virtual uint32_t ES_WIFI_GetJournalCount() = 0;
+    virtual uint16_t ES_WIFI_ReadJournal(uint32_t index, ES_WIFI_JournalEntry_t *entries, uint16_t max) = 0;
+    virtual bool ES_WIFI_GetLatency(uint8_t index, ES_WIFI_Latency_t *hist) = 0;
+    virtual void ES_WIFI_ResetLatency() = 0;
+    virtual void ES_WIFI_SetRecovery(bool enable) = 0;
+    virtual void ES_WIFI_GetRecoveryStats(ES_WIFI_RecoveryStats_t *stats) = 0;
+    virtual void ES_WIFI_ResetRecoveryStats() = 0;
 };
 #endif /*WiFi_Drv_H*/
 